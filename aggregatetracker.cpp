@@ -0,0 +1,126 @@
+/******************************************************************************************
+** File: aggregatetracker.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the SumMinMaxTracker class.
+** An item can only be the min while nothing newer is smaller, so pushed drops every
+** larger item from the back of m_mins; whatever is left is the min of a suffix of the
+** list, and the front is the min of all of it. m_maxes works the same way.
+******************************************************************************************/
+
+#include "aggregatetracker.h"
+
+/********************************************
+** Function: ~AggregateTracker()
+** Pre-conditions: None
+** Post-conditions: The tracker is destroyed
+********************************************/
+AggregateTracker::~AggregateTracker() {
+}
+
+/********************************************
+** Function: SumMinMaxTracker()
+** Pre-conditions: None
+** Post-conditions: A tracker with no items is created
+********************************************/
+SumMinMaxTracker::SumMinMaxTracker() {
+    m_sum = 0;
+    m_count = 0;
+}
+
+/********************************************
+** Function: pushed(int value)
+** Pre-conditions: None
+** Post-conditions: value is added to the sum and to both monotonic queues, amortized O(1).
+** Equal items are kept so popping one of them leaves the other.
+********************************************/
+void SumMinMaxTracker::pushed(int value) {
+    m_sum += value;
+    m_count++;
+    while (!m_mins.empty() && m_mins.back() > value) {
+        m_mins.pop_back();
+    }
+    m_mins.push_back(value);
+    while (!m_maxes.empty() && m_maxes.back() < value) {
+        m_maxes.pop_back();
+    }
+    m_maxes.push_back(value);
+}
+
+/********************************************
+** Function: popped(int value)
+** Pre-conditions: value is the oldest tracked item
+** Post-conditions: value is taken out of the sum, and off the front of a queue it heads,
+** O(1). Throws underflow_error if nothing is tracked.
+********************************************/
+void SumMinMaxTracker::popped(int value) {
+    if (m_count == 0) {
+        throw std::underflow_error("Nothing to pop from the tracker!");
+    }
+    m_sum -= value;
+    m_count--;
+    if (m_mins.front() == value) {
+        m_mins.pop_front();
+    }
+    if (m_maxes.front() == value) {
+        m_maxes.pop_front();
+    }
+}
+
+/********************************************
+** Function: reset()
+** Pre-conditions: None
+** Post-conditions: Nothing is tracked
+********************************************/
+void SumMinMaxTracker::reset() {
+    m_sum = 0;
+    m_count = 0;
+    m_mins.clear();
+    m_maxes.clear();
+}
+
+/********************************************
+** Function: sum()
+** Pre-conditions: None
+** Post-conditions: Returns the sum of the tracked items, 0 if there are none
+********************************************/
+long long SumMinMaxTracker::sum() {
+    return m_sum;
+}
+
+/********************************************
+** Function: min()
+** Pre-conditions: None
+** Post-conditions: Returns the smallest tracked item, throws underflow_error if there are none
+********************************************/
+int SumMinMaxTracker::min() {
+    if (m_count == 0) {
+        throw std::underflow_error("No items to take the min of!");
+    }
+    return m_mins.front();
+}
+
+/********************************************
+** Function: max()
+** Pre-conditions: None
+** Post-conditions: Returns the largest tracked item, throws underflow_error if there are none
+********************************************/
+int SumMinMaxTracker::max() {
+    if (m_count == 0) {
+        throw std::underflow_error("No items to take the max of!");
+    }
+    return m_maxes.front();
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of tracked items
+********************************************/
+int SumMinMaxTracker::count() {
+    return m_count;
+}
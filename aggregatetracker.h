@@ -0,0 +1,185 @@
+/******************************************************************************************
+** File: aggregatetracker.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the AggregateTracker interface and two
+** trackers. A BufferList with a tracker tells it about every item that becomes the
+** newest and every item that stops being the oldest, so the tracker can answer queries
+** over everything in the list without walking it.
+** SumMinMaxTracker keeps a running sum and monotonic queues for the min and the max.
+** TwoStackAggregate folds any associative combine over the items, oldest first.
+******************************************************************************************/
+
+
+
+#ifndef AGGREGATETRACKER_H
+#define AGGREGATETRACKER_H
+#include <deque>
+#include <vector>
+#include <optional>
+#include <stdexcept>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+class AggregateTracker{
+    public:
+    virtual ~AggregateTracker();        //destructor
+    virtual void pushed(int value) = 0; //value became the newest item
+    virtual void popped(int value) = 0; //value, the oldest item, was removed
+    virtual void reset() = 0;           //forgets every item
+};
+
+class SumMinMaxTracker : public AggregateTracker{
+    public:
+    friend class Grader;//Grader will have access to private members of SumMinMaxTracker
+    friend class Tester;//Tester will have access to private members of SumMinMaxTracker
+    SumMinMaxTracker();             //constructor, tracks nothing
+    void pushed(int value) override;
+    void popped(int value) override;
+    void reset() override;
+    long long sum();                //sum of the tracked items, 0 if there are none
+    int min();                      //smallest tracked item, throws underflow_error if there are none
+    int max();                      //largest tracked item, throws underflow_error if there are none
+    int count();                    //number of tracked items
+
+
+    private:
+    long long m_sum;        //running sum
+    int m_count;            //tracked items
+    std::deque<int> m_mins; //non decreasing, front is the min, each is smaller than everything newer
+    std::deque<int> m_maxes;//non increasing, front is the max, each is larger than everything newer
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+};
+
+template <typename T, typename Lift, typename Combine>
+class TwoStackAggregate : public AggregateTracker{
+    public:
+    friend class Grader;//Grader will have access to private members of TwoStackAggregate
+    friend class Tester;//Tester will have access to private members of TwoStackAggregate
+    TwoStackAggregate(Lift lift, Combine combine);  //lift is T(int), combine is T(T older, T newer) and associative
+    void pushed(int value) override;
+    void popped(int value) override;
+    void reset() override;
+    bool empty();                   //returns true if nothing is tracked
+    T query();                      //combine over every tracked item oldest first, throws underflow_error if empty
+
+
+    private:
+    Lift m_lift;            //turns an item into a T
+    Combine m_combine;      //associative, not necessarily commutative
+    std::vector<T> m_front; //front stack, m_front[i] folds its items from the (i+1)th newest on, the oldest is on top
+    std::vector<T> m_back;  //back stack, lifted items, newest on top
+    std::optional<T> m_backFold;    //fold of m_back, oldest first
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void flip();            //moves the back stack onto the front stack
+};
+
+/********************************************
+** Function: TwoStackAggregate(Lift lift, Combine combine)
+** Pre-conditions: combine(combine(a, b), c) == combine(a, combine(b, c))
+** Post-conditions: An empty aggregate is created
+********************************************/
+template <typename T, typename Lift, typename Combine>
+TwoStackAggregate<T, Lift, Combine>::TwoStackAggregate(Lift lift, Combine combine)
+    : m_lift(lift), m_combine(combine) {
+}
+
+/********************************************
+** Function: pushed(int value)
+** Pre-conditions: None
+** Post-conditions: value is lifted onto the back stack and folded into m_backFold, O(1)
+********************************************/
+template <typename T, typename Lift, typename Combine>
+void TwoStackAggregate<T, Lift, Combine>::pushed(int value) {
+    T lifted = m_lift(value);
+    m_backFold = m_backFold.has_value() ? m_combine(*m_backFold, lifted) : lifted;
+    m_back.push_back(lifted);
+}
+
+/********************************************
+** Function: popped(int value)
+** Pre-conditions: value is the oldest tracked item
+** Post-conditions: The oldest item is dropped from the top of the front stack. The back
+** stack is flipped first if the front stack is empty, so each item is moved once and
+** popped is amortized O(1). Throws underflow_error if nothing is tracked.
+********************************************/
+template <typename T, typename Lift, typename Combine>
+void TwoStackAggregate<T, Lift, Combine>::popped(int value) {
+    (void)value;
+    if (m_front.empty()) {
+        if (m_back.empty()) {
+            throw std::underflow_error("Nothing to pop from the aggregate!");
+        }
+        flip();
+    }
+    m_front.pop_back();
+}
+
+/********************************************
+** Function: reset()
+** Pre-conditions: None
+** Post-conditions: Nothing is tracked
+********************************************/
+template <typename T, typename Lift, typename Combine>
+void TwoStackAggregate<T, Lift, Combine>::reset() {
+    m_front.clear();
+    m_back.clear();
+    m_backFold.reset();
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if nothing is tracked
+********************************************/
+template <typename T, typename Lift, typename Combine>
+bool TwoStackAggregate<T, Lift, Combine>::empty() {
+    return m_front.empty() && m_back.empty();
+}
+
+/********************************************
+** Function: query()
+** Pre-conditions: None
+** Post-conditions: Returns the fold of every tracked item oldest first, O(1): the
+** front stack's top combined with m_backFold. Throws underflow_error if nothing is tracked.
+********************************************/
+template <typename T, typename Lift, typename Combine>
+T TwoStackAggregate<T, Lift, Combine>::query() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to aggregate!");
+    }
+    if (m_front.empty()) return *m_backFold;
+    if (m_back.empty()) return m_front.back();
+    return m_combine(m_front.back(), *m_backFold);
+}
+
+/********************************************
+** Function: flip()
+** Pre-conditions: The front stack is empty
+** Post-conditions: The back stack's items are pushed onto the front stack newest first,
+** each entry folding itself and every newer item, so the top folds them all
+********************************************/
+template <typename T, typename Lift, typename Combine>
+void TwoStackAggregate<T, Lift, Combine>::flip() {
+    m_front.reserve(m_back.size());
+    for (size_t i = m_back.size(); i-- > 0; ) {
+        if (m_front.empty()) {
+            m_front.push_back(m_back[i]);
+        }
+        else {
+            m_front.push_back(m_combine(m_back[i], m_front.back()));
+        }
+    }
+    m_back.clear();
+    m_backFold.reset();
+}
+#endif
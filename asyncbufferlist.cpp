@@ -0,0 +1,205 @@
+/******************************************************************************************
+** File: asyncbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the AsyncBufferList class.
+** The list is only non-empty while no coroutine waits, so an item handed to a waiter
+** never passes through the list. Coroutines are posted outside the lock.
+******************************************************************************************/
+
+#include "asyncbufferlist.h"
+#ifdef __cpp_impl_coroutine
+
+/********************************************
+** Function: AsyncBufferList(int minBufCapacity)
+** Pre-conditions: minBufCapacity is an integer larger than 0
+** Post-conditions: An empty list without waiters is created
+********************************************/
+AsyncBufferList::AsyncBufferList(int minBufCapacity) : m_list(minBufCapacity) {
+    m_head = nullptr;
+    m_tail = nullptr;
+    m_waiters = 0;
+}
+
+/********************************************
+** Function: ~AsyncBufferList()
+** Pre-conditions: No coroutine is suspended on this list
+** Post-conditions: The items are deallocated
+********************************************/
+AsyncBufferList::~AsyncBufferList() {
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: If a coroutine waits, the oldest one gets data and is posted to its
+** executor. Otherwise data is added to the list.
+********************************************/
+void AsyncBufferList::enqueue(const int& data) {
+    Waiter* waiter = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_head == nullptr) {
+            m_list.enqueue(data);
+            return;
+        }
+        waiter = m_head;
+        m_head = waiter->next;
+        if (m_head == nullptr) {
+            m_tail = nullptr;
+        }
+        m_waiters -= 1;
+        waiter->value = data;
+    }
+    waiter->executor->post(waiter->handle);
+}
+
+/********************************************
+** Function: tryDequeue(int& data)
+** Pre-conditions: None
+** Post-conditions: Returns true and stores the oldest item in data if the list is not
+** empty, otherwise returns false and data is unchanged
+********************************************/
+bool AsyncBufferList::tryDequeue(int& data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_list.empty()) return false;
+    data = m_list.dequeue();
+    return true;
+}
+
+/********************************************
+** Function: asyncDequeue(Executor& executor)
+** Pre-conditions: executor outlives the wait
+** Post-conditions: Returns an awaitable for the oldest item. A coroutine that has to
+** wait is resumed on executor.
+********************************************/
+AsyncBufferList::DequeueAwaiter AsyncBufferList::asyncDequeue(Executor& executor) {
+    return DequeueAwaiter(this, executor);
+}
+
+/********************************************
+** Function: asyncDequeueBatch(Executor& executor, int n)
+** Pre-conditions: n is 1 or larger, executor outlives the wait
+** Post-conditions: Returns an awaitable for a vector of 1 to n oldest items. It waits
+** only for the first item and takes whatever else is there when it resumes.
+********************************************/
+AsyncBufferList::BatchAwaiter AsyncBufferList::asyncDequeueBatch(Executor& executor, int n) {
+    return BatchAwaiter(this, executor, n);
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items in the list
+********************************************/
+int AsyncBufferList::count() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_list.count();
+}
+
+/********************************************
+** Function: waiters()
+** Pre-conditions: None
+** Post-conditions: Returns the number of suspended coroutines
+********************************************/
+int AsyncBufferList::waiters() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_waiters;
+}
+
+/********************************************
+** Function: suspend(Waiter& waiter)
+** Pre-conditions: waiter.handle and waiter.executor are set
+** Post-conditions: If an item arrived since await_ready, it is stored in waiter.value
+** and false is returned. Otherwise waiter is queued and true is returned.
+********************************************/
+bool AsyncBufferList::suspend(Waiter& waiter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_list.empty()) {
+        waiter.value = m_list.dequeue();
+        return false;
+    }
+    waiter.next = nullptr;
+    if (m_tail == nullptr) {
+        m_head = &waiter;
+    }
+    else {
+        m_tail->next = &waiter;
+    }
+    m_tail = &waiter;
+    m_waiters += 1;
+    return true;
+}
+
+/********************************************
+** Function: DequeueAwaiter(AsyncBufferList* list, Executor& executor)
+** Pre-conditions: list is not nullptr
+** Post-conditions: An awaiter that resumes on executor is created
+********************************************/
+AsyncBufferList::DequeueAwaiter::DequeueAwaiter(AsyncBufferList* list, Executor& executor) {
+    m_list = list;
+    m_waiter.next = nullptr;
+    m_waiter.executor = &executor;
+    m_waiter.value = 0;
+}
+
+/********************************************
+** Function: await_ready()
+** Pre-conditions: None
+** Post-conditions: Takes the oldest item and returns true if the list is not empty
+********************************************/
+bool AsyncBufferList::DequeueAwaiter::await_ready() {
+    return m_list->tryDequeue(m_waiter.value);
+}
+
+/********************************************
+** Function: await_suspend(std::coroutine_handle<> handle)
+** Pre-conditions: handle is the awaiting coroutine
+** Post-conditions: Returns false if an item could be taken after all, otherwise the
+** coroutine stays suspended until enqueue posts it
+********************************************/
+bool AsyncBufferList::DequeueAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    m_waiter.handle = handle;
+    return m_list->suspend(m_waiter);
+}
+
+/********************************************
+** Function: await_resume()
+** Pre-conditions: None
+** Post-conditions: Returns the item taken for this coroutine
+********************************************/
+int AsyncBufferList::DequeueAwaiter::await_resume() {
+    return m_waiter.value;
+}
+
+/********************************************
+** Function: BatchAwaiter(AsyncBufferList* list, Executor& executor, int n)
+** Pre-conditions: list is not nullptr
+** Post-conditions: An awaiter for up to n items that resumes on executor is created
+********************************************/
+AsyncBufferList::BatchAwaiter::BatchAwaiter(AsyncBufferList* list, Executor& executor, int n)
+    : DequeueAwaiter(list, executor) {
+    m_n = n;
+}
+
+/********************************************
+** Function: await_resume()
+** Pre-conditions: None
+** Post-conditions: Returns the item taken for this coroutine followed by up to m_n - 1
+** items that are in the list now, oldest first
+********************************************/
+std::vector<int> AsyncBufferList::BatchAwaiter::await_resume() {
+    std::vector<int> batch;
+    batch.push_back(m_waiter.value);
+
+    std::lock_guard<std::mutex> lock(m_list->m_mutex);
+    while ((int)batch.size() < m_n && !m_list->m_list.empty()) {
+        batch.push_back(m_list->m_list.dequeue());
+    }
+    return batch;
+}
+#endif
@@ -0,0 +1,97 @@
+/******************************************************************************************
+** File: asyncbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the AsyncBufferList class.
+** This class is a BufferList that coroutines can wait on. co_await list.asyncDequeue(ex)
+** returns an item at once if there is one, otherwise the coroutine is suspended on a
+** waiter queue. enqueue hands its item straight to the oldest waiter and posts that
+** coroutine to the executor it named, so no thread blocks and nothing polls.
+** Coroutines need C++20, the file is empty in older language modes.
+******************************************************************************************/
+
+
+
+#ifndef ASYNCBUFFERLIST_H
+#define ASYNCBUFFERLIST_H
+#ifdef __cpp_impl_coroutine
+#include "bufferlist.h"
+#include "executor.h"
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <vector>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+
+// return type of a coroutine that starts at once and frees itself when it finishes
+struct AsyncTask{
+    struct promise_type{
+        AsyncTask get_return_object() { return AsyncTask(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+class AsyncBufferList{
+    private:
+    struct Waiter{
+        Waiter *next;                       // next waiter, oldest first
+        std::coroutine_handle<> handle;     // the suspended coroutine
+        Executor *executor;                 // where the coroutine is resumed
+        int value;                          // item handed over by enqueue
+    };
+
+    public:
+    class DequeueAwaiter{
+        public:
+        DequeueAwaiter(AsyncBufferList * list, Executor & executor);
+        bool await_ready();                             //true if an item was taken without waiting
+        bool await_suspend(std::coroutine_handle<> handle); //registers the waiter unless an item arrived
+        int await_resume();                             //the item
+        protected:
+        AsyncBufferList *m_list;
+        Waiter m_waiter;
+    };
+    class BatchAwaiter : public DequeueAwaiter{
+        public:
+        BatchAwaiter(AsyncBufferList * list, Executor & executor, int n);
+        std::vector<int> await_resume();                //the first item plus up to n - 1 more
+        private:
+        int m_n;
+    };
+
+    friend class Grader;//Grader will have access to private members of AsyncBufferList
+    friend class Tester;//Tester will have access to private members of AsyncBufferList
+    AsyncBufferList(int minBufCapacity);    //constructor
+    ~AsyncBufferList();                     //destructor, no coroutine may still be waiting
+    AsyncBufferList(const AsyncBufferList & rhs) = delete;  //waiters point into this object
+    AsyncBufferList & operator=(const AsyncBufferList & rhs) = delete;
+    void enqueue(const int & data);         //add data, or hand it to the oldest waiting coroutine
+    bool tryDequeue(int & data);            //removes the oldest item into data if there is one
+    DequeueAwaiter asyncDequeue(Executor & executor);           //co_await for one item
+    BatchAwaiter asyncDequeueBatch(Executor & executor, int n); //co_await for 1 to n items
+    int count();        //number of items in the list
+    int waiters();      //number of suspended coroutines
+
+
+    private:
+    BufferList m_list;      //the items, guarded by m_mutex
+    std::mutex m_mutex;     //guards m_list and the waiter queue
+    Waiter *m_head;         //oldest waiting coroutine
+    Waiter *m_tail;         //newest waiting coroutine
+    int m_waiters;          //number of waiting coroutines
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    bool suspend(Waiter & waiter);      //queues waiter unless an item is available
+};
+#endif
+#endif
@@ -0,0 +1,1075 @@
+/******************************************************************************************
+** File: benchmark.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains performance measurements for the BufferList family of classes.
+** Every benchmark prints its timings to the console. Build with optimizations, e.g.
+** g++ -std=c++20 -O2 -pthread benchmark.cpp buffer.cpp bufferlist.cpp prioritybufferlist.cpp segmentarena.cpp
+** hugepageresource.cpp sizeclasses.cpp workerpool.cpp executor.cpp asyncbufferlist.cpp
+** eventbufferlist.cpp shardedbufferlist.cpp broadcastbufferlist.cpp durablebufferlist.cpp
+** exportwriter.cpp ingestreader.cpp aggregatetracker.cpp combiningbufferlist.cpp sharedbufferlist.cpp
+** The coroutine benchmark is skipped when built as C++17.
+******************************************************************************************/
+
+#include "bufferlist.h"
+#include "prioritybufferlist.h"
+#include "segmentarena.h"
+#include "hugepageresource.h"
+#include "sizeclasses.h"
+#include "workerpool.h"
+#include "asyncbufferlist.h"
+#include "eventbufferlist.h"
+#include "shardedbufferlist.h"
+#include "staticbufferlist.h"
+#include "broadcastbufferlist.h"
+#include "durablebufferlist.h"
+#include "exportwriter.h"
+#include "ingestreader.h"
+#include "aggregatetracker.h"
+#include "combiningbufferlist.h"
+#include "sharedbufferlist.h"
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+/********************************************
+** Function: benchPriorityDequeue(int levels, int N)
+** Pre-conditions: levels is between 1 and MAX_PRIORITY_LEVELS
+** Post-conditions: Compares polling one BufferList per level in order against
+** PriorityBufferList's bitmap lookup when only the lowest levels hold data
+********************************************/
+void benchPriorityDequeue(int levels, int N) {
+    long long checksum = 0;
+
+    // polling approach: one BufferList per level, checked in priority order
+    BufferList** polled = new BufferList*[levels];
+    for (int i = 0; i < levels; i++) {
+        polled[i] = new BufferList(DEFAULT_MIN_CAPACITY);
+    }
+    for (int i = 0; i < N; i++) {
+        polled[levels - 1 - (i % 2)]->enqueue(i);
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        for (int level = 0; level < levels; level++) {
+            if (!polled[level]->empty()) {
+                checksum += polled[level]->dequeue();
+                break;
+            }
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    auto pollTime = duration_cast<microseconds>(t2 - t1).count();
+
+    for (int i = 0; i < levels; i++) {
+        delete polled[i];
+    }
+    delete[] polled;
+
+    // bitmap approach
+    PriorityBufferList priority(levels, DEFAULT_MIN_CAPACITY);
+    for (int i = 0; i < N; i++) {
+        priority.enqueue(levels - 1 - (i % 2), i);
+    }
+
+    t1 = high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        checksum += priority.dequeue();
+    }
+    t2 = high_resolution_clock::now();
+    auto bitmapTime = duration_cast<microseconds>(t2 - t1).count();
+
+    cout << "Priority dequeue, " << levels << " levels, " << N << " items: polling "
+         << pollTime << " us, bitmap " << bitmapTime << " us (checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchArenaVersusHeap(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are larger than 0
+** Post-conditions: Times filling, draining and clearing a BufferList whose buffers
+** come from the default heap against one backed by a SegmentArena
+********************************************/
+void benchArenaVersusHeap(int minBufCapacity, int N) {
+    long long checksum = 0;
+    for (int useArena = 0; useArena < 2; useArena++) {
+        SegmentArena arena;
+        std::pmr::memory_resource* resource = useArena ? static_cast<std::pmr::memory_resource*>(&arena)
+                                                       : std::pmr::get_default_resource();
+        BufferList list(minBufCapacity, resource);
+
+        // fill and drain twice so the second round can reuse freed buffers
+        auto t1 = high_resolution_clock::now();
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < N; i++) {
+                list.enqueue(i);
+            }
+            for (int i = 0; i < N; i++) {
+                checksum += list.dequeue();
+            }
+        }
+        auto t2 = high_resolution_clock::now();
+        auto churnTime = duration_cast<microseconds>(t2 - t1).count();
+
+        for (int i = 0; i < N; i++) {
+            list.enqueue(i);
+        }
+        t1 = high_resolution_clock::now();
+        list.clear();
+        t2 = high_resolution_clock::now();
+        auto clearTime = duration_cast<microseconds>(t2 - t1).count();
+
+        cout << (useArena ? "SegmentArena" : "default heap") << ", min capacity " << minBufCapacity
+             << ", " << N << " items: fill/drain x2 " << churnTime << " us, clear " << clearTime << " us" << endl;
+    }
+    cout << "(checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchHugePages(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are larger than 0
+** Post-conditions: Times draining a deep BufferList whose large buffers live on
+** 4 KiB pages against one whose buffers are mapped on huge pages
+********************************************/
+void benchHugePages(int minBufCapacity, int N) {
+    long long checksum = 0;
+    for (int useHuge = 0; useHuge < 2; useHuge++) {
+        HugePageResource huge;
+        std::pmr::memory_resource* resource = useHuge ? static_cast<std::pmr::memory_resource*>(&huge)
+                                                      : std::pmr::get_default_resource();
+        BufferList list(minBufCapacity, resource);
+        for (int i = 0; i < N; i++) {
+            list.enqueue(i);
+        }
+
+        auto t1 = high_resolution_clock::now();
+        for (int i = 0; i < N; i++) {
+            checksum += list.dequeue();
+        }
+        auto t2 = high_resolution_clock::now();
+        auto drainTime = duration_cast<microseconds>(t2 - t1).count();
+
+        cout << (useHuge ? "huge pages" : "4 KiB pages") << ", min capacity " << minBufCapacity
+             << ", " << N << " items: drain " << drainTime << " us" << endl;
+        if (useHuge) {
+            huge.report(cout);
+        }
+    }
+    cout << "(checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchPrefetch(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are larger than 0
+** Post-conditions: Times draining a list much larger than the caches with and without
+** next buffer prefetching. Buffers grow from minBufCapacity to MAX_FACTOR times it,
+** so minBufCapacity decides how often dequeue crosses to a cold buffer.
+********************************************/
+void benchPrefetch(int minBufCapacity, int N) {
+    long long checksum = 0;
+    long long times[2];
+    for (int prefetch = 0; prefetch < 2; prefetch++) {
+        BufferList list(minBufCapacity);
+        list.setPrefetch(prefetch == 1);
+
+        for (int i = 0; i < N; i++) {
+            list.enqueue(i);
+        }
+
+        auto t1 = high_resolution_clock::now();
+        for (int i = 0; i < N; i++) {
+            checksum += list.dequeue();
+        }
+        auto t2 = high_resolution_clock::now();
+        times[prefetch] = duration_cast<microseconds>(t2 - t1).count();
+    }
+    cout << "Min buffer of " << minBufCapacity * sizeof(int) << " bytes, " << N << " items: no prefetch "
+         << times[0] << " us, prefetch " << times[1] << " us (checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: heapInUse()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes the C heap has handed out, or 0 where unknown
+********************************************/
+long long heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return (long long)mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/********************************************
+** Function: benchSizeClasses(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are larger than 0
+** Post-conditions: Prints the overhead per item with and without size classes, both as
+** requested by BufferList and as actually taken from the heap
+********************************************/
+void benchSizeClasses(int minBufCapacity, int N) {
+    for (int classes = 0; classes < 2; classes++) {
+        long long before = heapInUse();
+        BufferList list(minBufCapacity);
+        list.useSizeClasses(classes == 1);
+        for (int i = 0; i < N; i++) {
+            list.enqueue(i);
+        }
+        long long heap = heapInUse() - before;
+
+        cout << (classes ? "size classes" : "plain") << ", min capacity " << minBufCapacity << ", " << N
+             << " items: requested overhead " << list.overheadPerElement() << " B/item, heap overhead "
+             << (double)(heap - (long long)sizeof(int) * N) / N << " B/item" << endl;
+    }
+}
+
+/********************************************
+** Function: benchIdleLists(int lists, int items)
+** Pre-conditions: lists is larger than 0, items is 0 or larger
+** Post-conditions: Creates lists BufferLists holding items items each and prints the
+** heap taken per list beyond the BufferList objects themselves, and the time to
+** create and destroy them
+********************************************/
+void benchIdleLists(int lists, int items) {
+    vector<BufferList> queues;
+    queues.reserve(lists);
+    long long before = heapInUse();
+    auto t1 = high_resolution_clock::now();
+    for (int i = 0; i < lists; i++) {
+        queues.emplace_back(DEFAULT_MIN_CAPACITY);
+        for (int j = 0; j < items; j++) {
+            queues.back().enqueue(j);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    long long heap = heapInUse() - before;
+    queues.clear();
+    auto t3 = high_resolution_clock::now();
+
+    cout << lists << " lists of " << items << " items: " << (double)heap / lists << " heap B/list beyond "
+         << sizeof(BufferList) << " B objects, create " << duration_cast<microseconds>(t2 - t1).count()
+         << " us, destroy " << duration_cast<microseconds>(t3 - t2).count() << " us" << endl;
+}
+
+/********************************************
+** Function: benchCompression(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are larger than 0
+** Post-conditions: Prints resident bytes, compression ratio and enqueue/dequeue times
+** for a deep queue of timestamps with and without compression
+********************************************/
+void benchCompression(int minBufCapacity, int N) {
+    long long checksum = 0;
+    for (int compress = 0; compress < 2; compress++) {
+        BufferList list(minBufCapacity);
+        list.setCompression(compress == 1);
+
+        auto t1 = high_resolution_clock::now();
+        int timestamp = 1000000;
+        for (int i = 0; i < N; i++) {
+            timestamp += 1 + (i % 13);
+            list.enqueue(timestamp);
+        }
+        auto t2 = high_resolution_clock::now();
+        auto fillTime = duration_cast<microseconds>(t2 - t1).count();
+        long long resident = list.bytesAllocated();
+        double ratio = list.compressionRatio();
+
+        t1 = high_resolution_clock::now();
+        for (int i = 0; i < N; i++) {
+            checksum += list.dequeue();
+        }
+        t2 = high_resolution_clock::now();
+        auto drainTime = duration_cast<microseconds>(t2 - t1).count();
+
+        cout << (compress ? "compressed" : "plain") << ", " << N << " items: " << resident / 1024
+             << " KiB resident, ratio " << ratio << ", fill " << fillTime << " us, drain "
+             << drainTime << " us" << endl;
+    }
+    cout << "(checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchParallel(int minBufCapacity, int N)
+** Pre-conditions: minBufCapacity and N are positive integers
+** Post-conditions: Times a transform and a reduction over N items with pools of 1, 2,
+** 4 and 8 threads and prints the speedup over one thread. Scaling is bounded by the
+** number of cores of the machine and by memory bandwidth.
+********************************************/
+void benchParallel(int minBufCapacity, int N) {
+    BufferList list(minBufCapacity);
+    for (int i = 0; i < N; i++) {
+        list.enqueue(i);
+    }
+
+    long long transformBase = 0;
+    long long reduceBase = 0;
+    long long checksum = 0;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        WorkerPool pool(threads);
+
+        auto t1 = high_resolution_clock::now();
+        list.parallelForEach(pool, [](int & value) {
+            value = (int)((unsigned)value * 2654435761u >> 1);
+        });
+        auto t2 = high_resolution_clock::now();
+        long long transformTime = duration_cast<microseconds>(t2 - t1).count();
+
+        t1 = high_resolution_clock::now();
+        checksum += list.parallelReduce(pool, 0LL,
+            [](const int* data, int length) {
+                long long partial = 0;
+                for (int i = 0; i < length; i++) partial += data[i] % 1000;
+                return partial;
+            },
+            [](long long a, long long b) { return a + b; });
+        t2 = high_resolution_clock::now();
+        long long reduceTime = duration_cast<microseconds>(t2 - t1).count();
+
+        if (threads == 1) {
+            transformBase = transformTime;
+            reduceBase = reduceTime;
+        }
+        cout << threads << " threads, " << N << " items: transform " << transformTime
+             << " us (x" << (double)transformBase / (transformTime > 0 ? transformTime : 1)
+             << "), reduce " << reduceTime << " us (x"
+             << (double)reduceBase / (reduceTime > 0 ? reduceTime : 1) << ")" << endl;
+    }
+    cout << "(checksum " << checksum << ", " << thread::hardware_concurrency()
+         << " hardware threads)" << endl;
+}
+
+#ifdef __cpp_impl_coroutine
+/********************************************
+** Function: latencyConsumer(AsyncBufferList& list, SimpleExecutor& executor, int N, ...)
+** Pre-conditions: sent[i] is written before item i is enqueued
+** Post-conditions: Dequeues N items, adds up the time from enqueue to resumption and
+** tells the producer after every item
+********************************************/
+AsyncTask latencyConsumer(AsyncBufferList & list, SimpleExecutor & executor, int N,
+                          vector<high_resolution_clock::time_point> & sent,
+                          long long & totalNanos, atomic<int> & received) {
+    for (int i = 0; i < N; i++) {
+        int index = co_await list.asyncDequeue(executor);
+        totalNanos += duration_cast<nanoseconds>(high_resolution_clock::now() - sent[index]).count();
+        received.store(i + 1, memory_order_release);
+    }
+    executor.stop();
+}
+
+/********************************************
+** Function: benchWakeLatency(int N)
+** Pre-conditions: N is a positive integer
+** Post-conditions: A producer thread enqueues one item at a time into an empty list
+** while a coroutine waits on another thread, and prints the mean time from enqueue
+** until the coroutine runs again
+********************************************/
+void benchWakeLatency(int N) {
+    AsyncBufferList list(DEFAULT_MIN_CAPACITY);
+    SimpleExecutor executor;
+    vector<high_resolution_clock::time_point> sent(N);
+    long long totalNanos = 0;
+    atomic<int> received(0);
+
+    latencyConsumer(list, executor, N, sent, totalNanos, received);
+    thread consumer([&executor] { executor.run(); });
+    for (int i = 0; i < N; i++) {
+        while (list.waiters() == 0) {
+            this_thread::yield();
+        }
+        sent[i] = high_resolution_clock::now();
+        list.enqueue(i);
+        while (received.load(memory_order_acquire) <= i) {
+            this_thread::yield();
+        }
+    }
+    consumer.join();
+    cout << N << " wake ups: mean " << totalNanos / N << " ns from enqueue to resumption" << endl;
+}
+#endif
+
+#ifdef __linux__
+/********************************************
+** Function: benchEventFd(int burst, int N)
+** Pre-conditions: burst and N are positive integers
+** Post-conditions: A producer thread enqueues N items in bursts of burst items with a
+** short pause between bursts while an epoll loop drains the list in batches. Prints
+** the eventfd writes, reads and epoll waits per item.
+********************************************/
+void benchEventFd(int burst, int N) {
+    EventBufferList list(1024);
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, list.fd(), &event);
+
+    thread producer([&list, burst, N] {
+        for (int sent = 0; sent < N; ) {
+            for (int i = 0; i < burst && sent < N; i++, sent++) {
+                list.enqueue(sent);
+            }
+            auto pause = high_resolution_clock::now() + microseconds(20);
+            while (high_resolution_clock::now() < pause) {
+                this_thread::yield();
+            }
+        }
+    });
+
+    vector<int> batch(256);
+    long long received = 0;
+    long long waits = 0;
+    long long checksum = 0;
+    while (received < N) {
+        struct epoll_event ready;
+        waits++;
+        if (epoll_wait(epfd, &ready, 1, 100) <= 0) continue;
+        int moved;
+        while ((moved = list.dequeueBatch(batch.data(), (int)batch.size())) > 0) {
+            for (int i = 0; i < moved; i++) checksum += batch[i];
+            received += moved;
+        }
+    }
+    producer.join();
+    close(epfd);
+
+    double syscalls = (double)(list.signals() + list.acknowledgements() + waits);
+    cout << "burst " << burst << ", " << N << " items: " << (double)list.signals() / N << " writes, "
+         << (double)list.acknowledgements() / N << " reads, " << (double)waits / N
+         << " epoll waits, " << syscalls / N << " syscalls per item (checksum " << checksum << ")" << endl;
+}
+#endif
+
+/********************************************
+** Function: benchSharding(int threads, int N)
+** Pre-conditions: threads and N are positive integers
+** Post-conditions: threads threads each enqueue and dequeue N / threads items, first on
+** one BufferList behind a mutex, then on a ShardedBufferList with one shard per thread.
+** Prints the throughput of both.
+********************************************/
+void benchSharding(int threads, int N) {
+    int perThread = N / threads;
+
+    BufferList shared(1024);
+    mutex sharedMutex;
+    auto t1 = high_resolution_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&shared, &sharedMutex, perThread] {
+            long long sum = 0;
+            for (int i = 0; i < perThread; i++) {
+                {
+                    lock_guard<mutex> lock(sharedMutex);
+                    shared.enqueue(i);
+                }
+                lock_guard<mutex> lock(sharedMutex);
+                if (!shared.empty()) sum += shared.dequeue();
+            }
+            if (sum < 0) cout << sum;
+        });
+    }
+    for (thread & worker : workers) worker.join();
+    auto t2 = high_resolution_clock::now();
+    double sharedTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+
+    ShardedBufferList sharded(threads, 1024);
+    workers.clear();
+    t1 = high_resolution_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&sharded, perThread] {
+            long long sum = 0;
+            int data = 0;
+            for (int i = 0; i < perThread; i++) {
+                sharded.enqueue(i);
+                if (sharded.tryDequeue(data)) sum += data;
+            }
+            if (sum < 0) cout << sum;
+        });
+    }
+    for (thread & worker : workers) worker.join();
+    t2 = high_resolution_clock::now();
+    double shardedTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+
+    cout << threads << " threads: shared list " << (long long)(N / sharedTime) << " pairs/s, sharded "
+         << (long long)(N / shardedTime) << " pairs/s, " << sharded.steals() << " steals" << endl;
+}
+
+/********************************************
+** Function: benchStaticBuffer(int N)
+** Pre-conditions: N is a positive integer
+** Post-conditions: Pushes N items through a small queue, in bursts of 12, as a
+** BufferList, a StaticBufferList of 4 x 16 and a StaticBufferList of 4 x 12 (compare
+** wrap instead of mask), and prints the time of each
+********************************************/
+void benchStaticBuffer(int N) {
+    long long checksum = 0;
+
+    auto t1 = high_resolution_clock::now();
+    for (int rep = 0; rep < N / 12; rep++) {
+        BufferList list(16);
+        for (int i = 0; i < 12; i++) list.enqueue(rep + i);
+        for (int i = 0; i < 12; i++) checksum += list.dequeue();
+    }
+    auto t2 = high_resolution_clock::now();
+    cout << "BufferList(16), new per burst: " << duration_cast<microseconds>(t2 - t1).count() << " us" << endl;
+
+    BufferList reused(16);
+    t1 = high_resolution_clock::now();
+    for (int rep = 0; rep < N / 12; rep++) {
+        for (int i = 0; i < 12; i++) reused.enqueue(rep + i);
+        for (int i = 0; i < 12; i++) checksum += reused.dequeue();
+    }
+    t2 = high_resolution_clock::now();
+    cout << "BufferList(16), reused: " << duration_cast<microseconds>(t2 - t1).count() << " us" << endl;
+
+    t1 = high_resolution_clock::now();
+    for (int rep = 0; rep < N / 12; rep++) {
+        StaticBufferList<int, 16, 4> list;
+        for (int i = 0; i < 12; i++) list.enqueue(rep + i);
+        for (int i = 0; i < 12; i++) checksum += list.dequeue();
+    }
+    t2 = high_resolution_clock::now();
+    cout << "StaticBufferList<int, 16, 4>: " << duration_cast<microseconds>(t2 - t1).count() << " us" << endl;
+
+    StaticBufferList<int, 12, 4> odd;
+    t1 = high_resolution_clock::now();
+    for (int rep = 0; rep < N / 12; rep++) {
+        for (int i = 0; i < 12; i++) odd.enqueue(rep + i);
+        for (int i = 0; i < 12; i++) checksum += odd.dequeue();
+    }
+    t2 = high_resolution_clock::now();
+    cout << "StaticBufferList<int, 12, 4>, reused: " << duration_cast<microseconds>(t2 - t1).count() << " us" << endl;
+    cout << "(checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchBroadcast(int readers, int N)
+** Pre-conditions: readers and N are positive integers
+** Post-conditions: Delivers N items to readers consumers, once with a BufferList copy
+** per consumer and once with one BroadcastBufferList, and prints the enqueue time,
+** the read time and the peak heap of both
+********************************************/
+void benchBroadcast(int readers, int N) {
+    long long checksum = 0;
+
+    long long before = heapInUse();
+    vector<BufferList> copies(readers, BufferList(1024));
+    auto t1 = high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        for (BufferList & copy : copies) copy.enqueue(i);
+    }
+    auto t2 = high_resolution_clock::now();
+    long long copiesHeap = heapInUse() - before;
+    for (BufferList & copy : copies) {
+        while (!copy.empty()) checksum += copy.dequeue();
+    }
+    auto t3 = high_resolution_clock::now();
+    cout << readers << " readers, " << N << " items, list per reader: enqueue "
+         << duration_cast<microseconds>(t2 - t1).count() << " us, read "
+         << duration_cast<microseconds>(t3 - t2).count() << " us, " << copiesHeap / 1024 << " KiB" << endl;
+    copies.clear();
+
+    before = heapInUse();
+    BroadcastBufferList broadcast(1024);
+    vector<int> ids;
+    for (int r = 0; r < readers; r++) ids.push_back(broadcast.addReader());
+    t1 = high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        broadcast.enqueue(i);
+    }
+    t2 = high_resolution_clock::now();
+    long long broadcastHeap = heapInUse() - before;
+    for (int id : ids) {
+        while (!broadcast.empty(id)) checksum += broadcast.dequeue(id);
+    }
+    t3 = high_resolution_clock::now();
+    cout << readers << " readers, " << N << " items, broadcast: enqueue "
+         << duration_cast<microseconds>(t2 - t1).count() << " us, read "
+         << duration_cast<microseconds>(t3 - t2).count() << " us, " << broadcastHeap / 1024 << " KiB" << endl;
+    cout << "(checksum " << checksum << ")" << endl;
+}
+
+/********************************************
+** Function: benchDurable(int threads, int delayMicros, int N)
+** Pre-conditions: threads and N are positive integers, delayMicros is 0 or larger
+** Post-conditions: threads threads enqueue N items in total into a DurableBufferList
+** in the working directory with the given commit delay, and print the durable enqueue
+** rate and the items per fsync. The journal is deleted afterwards.
+********************************************/
+void benchDurable(int threads, int delayMicros, int N) {
+    string path = "benchmark_journal.tmp";
+    remove(path.c_str());
+    {
+        DurableBufferList list(path, 1024);
+        list.setGroupCommit(microseconds(delayMicros), 4 * threads);
+        unsigned long long before = list.syncs();
+
+        auto t1 = high_resolution_clock::now();
+        vector<thread> producers;
+        for (int t = 0; t < threads; t++) {
+            producers.emplace_back([&list, threads, N] {
+                for (int i = 0; i < N / threads; i++) {
+                    list.enqueue(i);
+                }
+            });
+        }
+        for (thread & producer : producers) producer.join();
+        auto t2 = high_resolution_clock::now();
+
+        double seconds = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+        unsigned long long syncs = list.syncs() - before;
+        cout << threads << " threads, delay " << delayMicros << " us: " << (long long)(N / seconds)
+             << " durable enqueues/s, " << (double)N / (syncs > 0 ? syncs : 1) << " items per fsync" << endl;
+    }
+    remove(path.c_str());
+}
+
+#ifdef __linux__
+/********************************************
+** Function: benchExport(int N)
+** Pre-conditions: N is a positive integer
+** Post-conditions: N items are written to /dev/null once with per-item iostream output,
+** the way dump() used to, and once per format with ExportWriter, printing the output
+** rate of each in MB/s
+********************************************/
+void benchExport(int N) {
+    BufferList list(1 << 16);
+    vector<int> items(N);
+    for (int i = 0; i < N; i++) {
+        items[i] = (i % 65536) * 7919 - N;
+        list.enqueue(items[i]);
+    }
+
+    int fd = open("/dev/null", O_WRONLY);
+    const char * names[] = {"plain", "CSV", "JSON"};
+    ExportFormat formats[] = {EXPORT_PLAIN, EXPORT_CSV, EXPORT_JSON};
+    long long plainBytes = 0;
+    for (int f = 0; f < 3; f++) {
+        ExportWriter out(fd);
+        auto t1 = high_resolution_clock::now();
+        list.exportTo(out, formats[f]);
+        out.flush();
+        auto t2 = high_resolution_clock::now();
+        double seconds = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+        cout << "ExportWriter " << names[f] << ": " << (long long)(out.bytesWritten() / seconds / 1000000)
+             << " MB/s (" << out.bytesWritten() << " bytes)" << endl;
+        if (formats[f] == EXPORT_PLAIN) plainBytes = out.bytesWritten();
+    }
+    close(fd);
+
+    // the old dump() loop, one operator<< per field, over a plain array of the same items
+    ofstream stream("/dev/null");
+    auto t1 = high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        stream << items[i] << "[" << i << "] ";
+    }
+    stream << endl;
+    auto t2 = high_resolution_clock::now();
+    double seconds = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+    // same text as the plain export
+    cout << "iostream per item: " << (long long)(plainBytes / seconds / 1000000) << " MB/s" << endl;
+}
+
+/********************************************
+** Function: benchIngest(int N)
+** Pre-conditions: N is a positive integer
+** Post-conditions: N ints are written to a newline separated text file and a binary
+** file in the working directory and read back into a BufferList with ifstream >> and
+** enqueue, with IngestReader::readText and with IngestReader::readBinary, printing the
+** input rate of each in GB/s. The files are deleted afterwards.
+********************************************/
+void benchIngest(int N) {
+    string textPath = "benchmark_ingest.txt.tmp";
+    string binaryPath = "benchmark_ingest.bin.tmp";
+    {
+        vector<int> items(N);
+        int fd = open(textPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ExportWriter text(fd);
+        for (int i = 0; i < N; i++) {
+            items[i] = (i % 65536) * 7919 - N;
+            text.appendInt(items[i]);
+            text.append('\n');
+        }
+        text.flush();
+        close(fd);
+        FILE* file = fopen(binaryPath.c_str(), "wb");
+        fwrite(items.data(), sizeof(int), N, file);
+        fclose(file);
+    }
+
+    long long textBytes = 0;
+    {
+        BufferList list(1 << 16);
+        ifstream in(textPath);
+        auto t1 = high_resolution_clock::now();
+        int value;
+        while (in >> value) {
+            list.enqueue(value);
+        }
+        auto t2 = high_resolution_clock::now();
+        double seconds = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+        in.clear();
+        in.seekg(0, ios::end);
+        textBytes = in.tellg();
+        cout << "ifstream >> and enqueue: " << textBytes / seconds / 1e9 << " GB/s, "
+             << list.count() << " items" << endl;
+    }
+
+    const char * names[] = {"IngestReader text", "IngestReader binary"};
+    string paths[] = {textPath, binaryPath};
+    for (int f = 0; f < 2; f++) {
+        BufferList list(1 << 16);
+        int fd = open(paths[f].c_str(), O_RDONLY);
+        IngestReader reader(fd);
+        auto t1 = high_resolution_clock::now();
+        long long added = (f == 0) ? reader.readText(list) : reader.readBinary(list);
+        auto t2 = high_resolution_clock::now();
+        close(fd);
+        double seconds = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+        cout << names[f] << ": " << reader.bytesRead() / seconds / 1e9 << " GB/s, "
+             << added << " items" << endl;
+    }
+    remove(textPath.c_str());
+    remove(binaryPath.c_str());
+}
+#endif
+
+/********************************************
+** Function: benchCombining(int threads, int N)
+** Pre-conditions: threads and N are positive integers
+** Post-conditions: threads threads each enqueue and try to dequeue N / threads items,
+** first on one BufferList behind a mutex, then on a CombiningBufferList. Prints the
+** throughput of both and the average number of requests per combining pass.
+********************************************/
+void benchCombining(int threads, int N) {
+    int perThread = N / threads;
+
+    BufferList shared(1024);
+    mutex sharedMutex;
+    auto t1 = high_resolution_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&shared, &sharedMutex, perThread] {
+            long long sum = 0;
+            for (int i = 0; i < perThread; i++) {
+                {
+                    lock_guard<mutex> lock(sharedMutex);
+                    shared.enqueue(i);
+                }
+                lock_guard<mutex> lock(sharedMutex);
+                if (!shared.empty()) sum += shared.dequeue();
+            }
+            if (sum < 0) cout << sum;
+        });
+    }
+    for (thread & worker : workers) worker.join();
+    auto t2 = high_resolution_clock::now();
+    double sharedTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+
+    CombiningBufferList combining(1024);
+    workers.clear();
+    t1 = high_resolution_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&combining, perThread] {
+            long long sum = 0;
+            int data = 0;
+            for (int i = 0; i < perThread; i++) {
+                combining.enqueue(i);
+                if (combining.tryDequeue(data)) sum += data;
+            }
+            if (sum < 0) cout << sum;
+        });
+    }
+    for (thread & worker : workers) worker.join();
+    t2 = high_resolution_clock::now();
+    double combiningTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+
+    cout << threads << " threads: mutex " << (long long)(N / sharedTime) << " pairs/s, combining "
+         << (long long)(N / combiningTime) << " pairs/s, "
+         << (double)combining.combined() / combining.passes() << " requests per pass" << endl;
+}
+
+#ifdef __linux__
+/********************************************
+** Function: benchSharedMemory(int batch, int N)
+** Pre-conditions: batch and N are positive integers, N is a multiple of batch
+** Post-conditions: A forked consumer process sums N ints sent in batches of batch, first
+** written to and read from a pipe, then enqueued into a SharedBufferList and read in
+** place with peekBatch and consume. Prints the rate of both.
+********************************************/
+void benchSharedMemory(int batch, int N) {
+    vector<int> items(batch);
+    for (int i = 0; i < batch; i++) items[i] = i;
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) return;
+    cout.flush();
+    auto t1 = high_resolution_clock::now();
+    pid_t child = fork();
+    if (child == 0) {
+        close(pipeFds[1]);
+        vector<int> in(batch);
+        long long sum = 0;
+        long long bytes = 0;
+        while (bytes < (long long)N * (long long)sizeof(int)) {
+            ssize_t got = read(pipeFds[0], in.data(), batch * sizeof(int));
+            if (got <= 0) break;
+            for (ssize_t i = 0; i < got / (ssize_t)sizeof(int); i++) sum += in[i];
+            bytes += got;
+        }
+        _exit(sum < 0 ? 1 : 0);
+    }
+    close(pipeFds[0]);
+    for (int sent = 0; sent < N; sent += batch) {
+        size_t length = batch * sizeof(int);
+        const char* data = (const char*)items.data();
+        while (length > 0) {
+            ssize_t written = write(pipeFds[1], data, length);
+            if (written <= 0) break;
+            data += written;
+            length -= written;
+        }
+    }
+    close(pipeFds[1]);
+    waitpid(child, nullptr, 0);
+    auto t2 = high_resolution_clock::now();
+    double pipeTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+
+    string name = "/benchmark_shm_" + to_string(getpid());
+    SharedBufferList::remove(name);
+    double sharedTime = 0;
+    {
+        SharedBufferList producer(name, 16384, 16);
+        cout.flush();
+        t1 = high_resolution_clock::now();
+        child = fork();
+        if (child == 0) {
+            SharedBufferList consumer(name);
+            long long sum = 0;
+            int received = 0;
+            while (received < N) {
+                BufferView view = consumer.peekBatch(batch);
+                if (view.total == 0) {
+                    sched_yield();
+                    continue;
+                }
+                for (int s = 0; s < view.spanCount; s++) {
+                    for (int i = 0; i < view.spans[s].length; i++) sum += view.spans[s].data[i];
+                }
+                received += consumer.consume(view.total);
+            }
+            _exit(sum < 0 ? 1 : 0);
+        }
+        for (int sent = 0; sent < N; ) {
+            int added = producer.enqueueBatch(items.data(), batch);
+            if (added < batch) {
+                // the rest of the batch waits for the consumer to hand buffers back
+                int more = added;
+                while (more < batch) {
+                    sched_yield();
+                    more += producer.enqueueBatch(items.data() + more, batch - more);
+                }
+            }
+            sent += batch;
+        }
+        waitpid(child, nullptr, 0);
+        t2 = high_resolution_clock::now();
+        sharedTime = duration_cast<microseconds>(t2 - t1).count() / 1000000.0;
+    }
+    SharedBufferList::remove(name);
+
+    cout << "batch " << batch << ": pipe " << (long long)(N / pipeTime) << " items/s, shared memory "
+         << (long long)(N / sharedTime) << " items/s" << endl;
+}
+#endif
+
+// sum, min and max of a window, the result type of the recompute in benchAggregates
+struct WindowStats{
+    long long sum;
+    int min;
+    int max;
+};
+
+/********************************************
+** Function: benchAggregates(int window, int N)
+** Pre-conditions: window and N are positive integers
+** Post-conditions: A list holding window items takes N enqueue and dequeue pairs, and
+** the sum, min and max are read after each pair, once recomputed with parallelReduce
+** on a one thread pool and once from a SumMinMaxTracker. Prints the time per pair.
+********************************************/
+void benchAggregates(int window, int N) {
+    WorkerPool pool(1);
+    long long checksum[2] = {0, 0};
+    double nanos[2];
+    for (int tracked = 0; tracked < 2; tracked++) {
+        BufferList list(64);
+        SumMinMaxTracker stats;
+        if (tracked) list.setTracker(&stats);
+        for (int i = 0; i < window; i++) {
+            list.enqueue((i * 7919) % 10007);
+        }
+
+        auto t1 = high_resolution_clock::now();
+        for (int i = window; i < window + N; i++) {
+            list.enqueue((i * 7919) % 10007);
+            list.dequeue();
+            if (tracked) {
+                checksum[1] += stats.sum() + stats.min() + stats.max();
+            }
+            else {
+                WindowStats all = list.parallelReduce(pool, WindowStats{0, 2147483647, -2147483647 - 1},
+                    [](const int* data, int length) {
+                        WindowStats part = {0, 2147483647, -2147483647 - 1};
+                        for (int j = 0; j < length; j++) {
+                            part.sum += data[j];
+                            if (data[j] < part.min) part.min = data[j];
+                            if (data[j] > part.max) part.max = data[j];
+                        }
+                        return part;
+                    },
+                    [](WindowStats a, WindowStats b) {
+                        return WindowStats{a.sum + b.sum, a.min < b.min ? a.min : b.min, a.max > b.max ? a.max : b.max};
+                    });
+                checksum[0] += all.sum + all.min + all.max;
+            }
+        }
+        auto t2 = high_resolution_clock::now();
+        nanos[tracked] = duration_cast<nanoseconds>(t2 - t1).count() / (double)N;
+    }
+    cout << "window " << window << ": recompute " << nanos[0] << " ns, tracker " << nanos[1]
+         << " ns per pair" << (checksum[0] == checksum[1] ? "" : " (MISMATCH)") << endl;
+}
+
+int main() {
+    cout << "Priority levels" << endl;
+    benchPriorityDequeue(8, 1000000);
+    benchPriorityDequeue(64, 1000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Memory resources" << endl;
+    benchArenaVersusHeap(10, 2000000);
+    benchArenaVersusHeap(1000, 2000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Huge pages" << endl;
+    benchHugePages(1 << 20, 50000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Next buffer prefetch" << endl;
+    benchPrefetch(16, 30000000);          // 64 B to 1 KiB, well below L1
+    benchPrefetch(1024, 30000000);        // 4 KiB to 64 KiB, around L1
+    benchPrefetch(16384, 30000000);       // 64 KiB to 1 MiB, above L1, within L2
+    benchPrefetch(1 << 20, 30000000);     // 4 MiB and up, above L2
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Size classes" << endl;
+    SizeClassTable::instance().dump();
+    benchSizeClasses(10, 1000000);
+    benchSizeClasses(1000, 1000000);
+    benchSizeClasses(1000, 1000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Idle and tiny lists" << endl;
+    benchIdleLists(1000000, 0);
+    benchIdleLists(1000000, 4);
+    benchIdleLists(1000000, INLINE_CAPACITY + 1);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Compression" << endl;
+    benchCompression(4096, 20000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Parallel processing" << endl;
+    benchParallel(4096, 50000000);
+    cout << "---------------------------------------------------" << endl;
+
+#ifdef __linux__
+    cout << "Eventfd readiness" << endl;
+    benchEventFd(1, 200000);
+    benchEventFd(16, 1000000);
+    benchEventFd(256, 5000000);
+    benchEventFd(4096, 20000000);
+    cout << "---------------------------------------------------" << endl;
+#endif
+
+    cout << "Static buffers" << endl;
+    benchStaticBuffer(12000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Broadcast readers" << endl;
+    benchBroadcast(3, 10000000);
+    benchBroadcast(8, 10000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Durable journal" << endl;
+    benchDurable(1, 0, 2000);           // one fsync per enqueue
+    benchDurable(8, 0, 8000);
+    benchDurable(8, 200, 8000);
+    benchDurable(32, 1000, 32000);
+    cout << "---------------------------------------------------" << endl;
+
+#ifdef __linux__
+    cout << "Export" << endl;
+    benchExport(10000000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Ingest" << endl;
+    benchIngest(20000000);
+    cout << "---------------------------------------------------" << endl;
+#endif
+
+    cout << "Sliding aggregates" << endl;
+    benchAggregates(16, 2000000);
+    benchAggregates(1024, 200000);
+    benchAggregates(65536, 5000);
+    cout << "---------------------------------------------------" << endl;
+
+    cout << "Sharding" << endl;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        benchSharding(threads, 8000000);
+    }
+    cout << "(" << thread::hardware_concurrency() << " hardware threads)" << endl;
+    cout << "---------------------------------------------------" << endl;
+
+#ifdef __linux__
+    cout << "Shared memory between processes" << endl;
+    benchSharedMemory(16, 16000000);
+    benchSharedMemory(1024, 64000000);
+    cout << "---------------------------------------------------" << endl;
+#endif
+
+    cout << "Flat combining" << endl;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        benchCombining(threads, 4000000);
+    }
+    cout << "(" << thread::hardware_concurrency() << " hardware threads)" << endl;
+    cout << "---------------------------------------------------" << endl;
+
+#ifdef __cpp_impl_coroutine
+    cout << "Coroutine wake up" << endl;
+    benchWakeLatency(100000);
+    cout << "---------------------------------------------------" << endl;
+#else
+    cout << "Coroutine wake up skipped (needs C++20)" << endl;
+#endif
+
+    return 0;
+}
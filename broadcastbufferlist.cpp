@@ -0,0 +1,260 @@
+/******************************************************************************************
+** File: broadcastbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the BroadcastBufferList class.
+** Segments are only ever appended to, so items sit at index 0 to m_count - 1 of their
+** segment and readers index them directly. Segments grow like the ones of BufferList.
+******************************************************************************************/
+
+#include "broadcastbufferlist.h"
+#include "bufferlist.h"
+#include <stdexcept>
+#include <iostream>
+
+/********************************************
+** Function: BroadcastBufferList(int minBufCapacity)
+** Pre-conditions: None
+** Post-conditions: An empty chain with one segment and no readers is created. A
+** minBufCapacity less than 1 is replaced by DEFAULT_MIN_CAPACITY.
+********************************************/
+BroadcastBufferList::BroadcastBufferList(int minBufCapacity) {
+    m_minBufCapacity = (minBufCapacity < 1) ? DEFAULT_MIN_CAPACITY : minBufCapacity;
+    m_head = new Buffer(m_minBufCapacity);
+    m_tail = m_head;
+    m_headSequence = 0;
+    m_enqueued = 0;
+    m_segments = 1;
+}
+
+/********************************************
+** Function: ~BroadcastBufferList()
+** Pre-conditions: None
+** Post-conditions: Every segment is deallocated, the reader ids become invalid
+********************************************/
+BroadcastBufferList::~BroadcastBufferList() {
+    while (m_head != nullptr) {
+        Buffer* next = m_head->m_next;
+        delete m_head;
+        m_head = next;
+    }
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: data is appended once and becomes visible to every reader. When the
+** tail segment is full a larger one is linked after it and segments no reader needs
+** any more are deleted.
+********************************************/
+void BroadcastBufferList::enqueue(const int& data) {
+    if (m_tail->full()) {
+        int newSize = m_tail->capacity() * INCREASE_FACTOR;
+        if (newSize > MAX_FACTOR * m_minBufCapacity) {
+            newSize = m_minBufCapacity;
+        }
+        Buffer* segment = new Buffer(newSize);
+        segment->m_prev = m_tail;
+        m_tail->m_next = segment;
+        m_tail = segment;
+        m_segments += 1;
+        reclaim();
+    }
+    m_tail->enqueue(data);
+    m_enqueued += 1;
+}
+
+/********************************************
+** Function: addReader()
+** Pre-conditions: None
+** Post-conditions: A reader positioned after the newest item is registered and its id
+** returned. Ids of removed readers are reused.
+********************************************/
+int BroadcastBufferList::addReader() {
+    Reader reader;
+    reader.active = true;
+    reader.segment = m_tail;
+    reader.index = m_tail->count();
+    reader.sequence = m_enqueued;
+
+    for (int i = 0; i < (int)m_readers.size(); i++) {
+        if (!m_readers[i].active) {
+            m_readers[i] = reader;
+            return i;
+        }
+    }
+    m_readers.push_back(reader);
+    return (int)m_readers.size() - 1;
+}
+
+/********************************************
+** Function: removeReader(int reader)
+** Pre-conditions: None
+** Post-conditions: reader is unregistered and segments that only it still needed are
+** deleted. Throws std::out_of_range if reader is not registered.
+********************************************/
+void BroadcastBufferList::removeReader(int reader) {
+    readerAt(reader).active = false;
+    reclaim();
+}
+
+/********************************************
+** Function: dequeue(int reader)
+** Pre-conditions: None
+** Post-conditions: Returns reader's oldest unread item and moves reader past it. The
+** item stays for the other readers. Throws std::underflow_error if reader has read
+** everything, std::out_of_range if reader is not registered.
+********************************************/
+int BroadcastBufferList::dequeue(int reader) {
+    Reader & position = readerAt(reader);
+    if (position.sequence == m_enqueued) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+
+    if (position.index == position.segment->capacity()) {
+        // the next item is in the following segment, the one left behind may be free now
+        Buffer* passed = position.segment;
+        position.segment = passed->m_next;
+        position.index = 0;
+        if (passed == m_head) {
+            reclaim();
+        }
+    }
+
+    int data = position.segment->m_buffer[position.index];
+    position.index += 1;
+    position.sequence += 1;
+    return data;
+}
+
+/********************************************
+** Function: empty(int reader)
+** Pre-conditions: None
+** Post-conditions: Returns true if reader has read every item. Throws
+** std::out_of_range if reader is not registered.
+********************************************/
+bool BroadcastBufferList::empty(int reader) {
+    return readerAt(reader).sequence == m_enqueued;
+}
+
+/********************************************
+** Function: lag(int reader)
+** Pre-conditions: None
+** Post-conditions: Returns how many items reader has not read yet. Throws
+** std::out_of_range if reader is not registered.
+********************************************/
+long long BroadcastBufferList::lag(int reader) {
+    return m_enqueued - readerAt(reader).sequence;
+}
+
+/********************************************
+** Function: slowestReader()
+** Pre-conditions: None
+** Post-conditions: Returns the registered reader with the largest lag, the lowest id
+** on a tie, or -1 if there are no readers
+********************************************/
+int BroadcastBufferList::slowestReader() {
+    int slowest = -1;
+    for (int i = 0; i < (int)m_readers.size(); i++) {
+        if (m_readers[i].active && (slowest == -1 || m_readers[i].sequence < m_readers[slowest].sequence)) {
+            slowest = i;
+        }
+    }
+    return slowest;
+}
+
+/********************************************
+** Function: readers()
+** Pre-conditions: None
+** Post-conditions: Returns the number of registered readers
+********************************************/
+int BroadcastBufferList::readers() {
+    int active = 0;
+    for (const Reader & reader : m_readers) {
+        if (reader.active) active++;
+    }
+    return active;
+}
+
+/********************************************
+** Function: retained()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items still held in the segments
+********************************************/
+long long BroadcastBufferList::retained() {
+    return m_enqueued - m_headSequence;
+}
+
+/********************************************
+** Function: segments()
+** Pre-conditions: None
+** Post-conditions: Returns the number of segments in the chain
+********************************************/
+int BroadcastBufferList::segments() {
+    return m_segments;
+}
+
+/********************************************
+** Function: dump()
+** Pre-conditions: None
+** Post-conditions: The segments and every reader's position and lag are printed
+********************************************/
+void BroadcastBufferList::dump() {
+    for (Buffer* segment = m_head; segment != nullptr; segment = segment->m_next) {
+        segment->dump();
+    }
+    for (int i = 0; i < (int)m_readers.size(); i++) {
+        if (m_readers[i].active) {
+            std::cout << "reader " << i << ": index " << m_readers[i].index << ", lag "
+                      << m_enqueued - m_readers[i].sequence << std::endl;
+        }
+    }
+}
+
+/********************************************
+** Function: readerAt(int reader)
+** Pre-conditions: None
+** Post-conditions: Returns the slot of reader. Throws std::out_of_range if reader is
+** not registered.
+********************************************/
+BroadcastBufferList::Reader & BroadcastBufferList::readerAt(int reader) {
+    if (reader < 0 || reader >= (int)m_readers.size() || !m_readers[reader].active) {
+        throw std::out_of_range("Reader is not registered!");
+    }
+    return m_readers[reader];
+}
+
+/********************************************
+** Function: reclaim()
+** Pre-conditions: None
+** Post-conditions: Leading full segments whose items every reader has read are deleted,
+** the tail is always kept. A reader parked at the end of a deleted segment is moved to
+** the start of the next one.
+********************************************/
+void BroadcastBufferList::reclaim() {
+    long long oldest = m_enqueued;
+    for (const Reader & reader : m_readers) {
+        if (reader.active && reader.sequence < oldest) {
+            oldest = reader.sequence;
+        }
+    }
+
+    while (m_head != m_tail && m_headSequence + m_head->capacity() <= oldest) {
+        Buffer* next = m_head->m_next;
+        for (Reader & reader : m_readers) {
+            if (reader.active && reader.segment == m_head) {
+                reader.segment = next;
+                reader.index = 0;
+            }
+        }
+        m_headSequence += m_head->capacity();
+        delete m_head;
+        m_head = next;
+        m_head->m_prev = nullptr;
+        m_segments -= 1;
+    }
+}
@@ -0,0 +1,67 @@
+/******************************************************************************************
+** File: broadcastbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the BroadcastBufferList class.
+** This class is a chain of Buffer segments that several readers consume independently.
+** Every item is enqueued once and every reader sees every item enqueued after it was
+** added, in FIFO order, from its own position (segment and index). Reading does not
+** remove anything; a segment is deleted once every reader has moved past it, so the
+** slowest reader decides how much is kept. lag and slowestReader find that reader.
+******************************************************************************************/
+
+
+
+#ifndef BROADCASTBUFFERLIST_H
+#define BROADCASTBUFFERLIST_H
+#include "buffer.h"
+#include <vector>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+class BroadcastBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of BroadcastBufferList
+    friend class Tester;//Tester will have access to private members of BroadcastBufferList
+    BroadcastBufferList(int minBufCapacity);    //constructor
+    ~BroadcastBufferList();                     //destructor
+    BroadcastBufferList(const BroadcastBufferList & rhs) = delete;  //readers point into the segments
+    BroadcastBufferList & operator=(const BroadcastBufferList & rhs) = delete;
+    void enqueue(const int & data);     //add data once for every reader
+    int addReader();                    //registers a reader that starts after the newest item, returns its id
+    void removeReader(int reader);      //unregisters reader, segments only it held are deleted
+    int dequeue(int reader);            //returns reader's next item and moves it past
+    bool empty(int reader);             //returns true if reader has nothing left to read
+    long long lag(int reader);          //number of items reader has not read yet
+    int slowestReader();                //the reader with the largest lag, -1 if there are none
+    int readers();                      //number of registered readers
+    long long retained();               //items still held because some reader has not passed them
+    int segments();                     //number of segments in the chain
+    void dump();                        //prints out the contents, for debugging purposes
+
+
+    private:
+    struct Reader{
+        bool active;            // whether this slot holds a registered reader
+        Buffer *segment;        // segment of the next item to read
+        int index;              // slot of the next item in segment, may equal its capacity
+        long long sequence;     // number of items enqueued before the next item
+    };
+    Buffer *m_head;             //oldest segment still held
+    Buffer *m_tail;             //segment new items go to
+    long long m_headSequence;   //sequence number of the first item of m_head
+    long long m_enqueued;       //number of items enqueued so far
+    int m_segments;             //number of segments in the chain
+    int m_minBufCapacity;       //capacity of the first segment and where growth starts over
+    std::vector<Reader> m_readers;  //reader slots, the slot number is the reader id
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    Reader & readerAt(int reader);  //returns the slot of a registered reader, throws if there is none
+    void reclaim();                 //deletes the leading segments every reader has passed
+};
+#endif
@@ -14,17 +14,27 @@
 
 #include "buffer.h"
 #include <stdexcept>
+#include <cstdint>
+#include <cstring>
 
 /********************************************
-** Function: Buffer(int capacity)
-** Pre-conditions: capacity is an integer larger than or equal to 0
-** Post-conditions: A Buffer object is created with the specified capacity
+** Function: Buffer(int capacity, std::pmr::memory_resource* resource)
+** Pre-conditions: capacity is an integer larger than or equal to 0, resource is not nullptr
+** Post-conditions: A Buffer object is created with the specified capacity,
+** its storage comes from resource
 ********************************************/
-Buffer::Buffer(int capacity) {
+Buffer::Buffer(int capacity, std::pmr::memory_resource* resource) {
     
     m_count = 0;
     m_start = 0;
     m_end = 0;
+    m_next = nullptr;
+    m_prev = nullptr;
+    m_resource = resource;
+    m_overwrite = false;
+    m_compressed = false;
+    m_packedBytes = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
 
     if (capacity < 1) {
         // If capacity is less than 1, set buffer to nullptr
@@ -32,10 +42,8 @@ Buffer::Buffer(int capacity) {
         m_buffer = nullptr;
     } 
     else {
-        m_capacity = capacity;
-
-        // Allocate memory for the buffer on the heap
-        m_buffer = new int[capacity];
+        // Allocate memory for the buffer from the memory resource
+        allocateStorage(capacity);
 
         // Initialize buffer to all zeros
         for (int i = 0; i < m_capacity; i++) {
@@ -44,15 +52,63 @@ Buffer::Buffer(int capacity) {
     }
 }
 
+/********************************************
+** Function: Buffer(int* storage, int capacity)
+** Pre-conditions: storage has room for capacity items, starts on a cache line and
+** outlives the buffer, capacity is 1 or larger
+** Post-conditions: A Buffer object is created over storage. It never allocates or frees,
+** clear only drops the items, and it cannot be compressed.
+********************************************/
+Buffer::Buffer(int* storage, int capacity) {
+    m_buffer = storage;
+    m_capacity = capacity;
+    m_count = 0;
+    m_start = 0;
+    m_end = 0;
+    m_next = nullptr;
+    m_prev = nullptr;
+    m_resource = nullptr;
+    m_overwrite = false;
+    m_compressed = false;
+    m_packedBytes = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
+}
+
+/********************************************
+** Function: allocateStorage(int capacity)
+** Pre-conditions: capacity is 0 or larger, m_buffer owns no memory
+** Post-conditions: m_buffer points to room for capacity items from m_resource, starting
+** on a cache line. A capacity of 0 still gets a distinct pointer, the same as new int[0].
+********************************************/
+void Buffer::allocateStorage(int capacity) {
+    m_capacity = capacity;
+    m_buffer = static_cast<int*>(m_resource->allocate(sizeof(int) * capacity, CACHE_LINE_SIZE));
+}
+
 /********************************************
 ** Function: clear()
 ** Pre-conditions: None
-** Post-conditions: The buffer is cleared and memory is deallocated
+** Post-conditions: The buffer is cleared and memory is deallocated. Borrowed storage
+** is kept, only the items are dropped.
 ********************************************/
 void Buffer::clear() {
     if (m_buffer == nullptr) return; // Added check for nullptr
 
-    delete[] m_buffer;
+    if (m_resource == nullptr) {
+        m_count = 0;
+        m_start = 0;
+        m_end = 0;
+        return;
+    }
+
+    if (m_compressed) {
+        m_resource->deallocate(m_buffer, m_packedBytes, 1);
+    }
+    else {
+        m_resource->deallocate(m_buffer, sizeof(int) * m_capacity, CACHE_LINE_SIZE);
+    }
+    m_compressed = false;
+    m_packedBytes = 0;
     m_count = 0;
     m_start = 0;
     m_end = 0;
@@ -110,10 +166,20 @@ bool Buffer::empty() {
 /********************************************
 ** Function: enqueue(int data)
 ** Pre-conditions: data is an integer to be added to the buffer
-** Post-conditions: data is added to the buffer, throws overflow_error if the buffer is full
+** Post-conditions: data is added to the buffer. If the buffer is full it throws overflow_error,
+** or in overwrite mode replaces the oldest item and counts it as dropped.
 ********************************************/
 void Buffer::enqueue(int data) {
     if (full()) {
+        if (m_overwrite && m_capacity > 0) {
+            // the slot at m_end holds the oldest item, write over it and move the start along
+            m_buffer[m_end] = data;
+            m_end = (m_end + 1) % m_capacity;
+            m_start = m_end;
+            // single writer, so a plain load and store keeps readers safe without a locked add
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
         // If buffer is full, throw an exception
         throw std::overflow_error("No space for enqueue! Creating a new buffer..."); // Placeholder until we implement BufferList
     }
@@ -144,26 +210,345 @@ int Buffer::dequeue() {
     return data;
 }
 
+/********************************************
+** Function: enqueueFront(int data)
+** Pre-conditions: data is an integer to be added to the buffer
+** Post-conditions: data is added before the oldest item so it is dequeued next,
+** throws overflow_error if the buffer is full
+********************************************/
+void Buffer::enqueueFront(int data) {
+    if (full()) {
+        throw std::overflow_error("No space for enqueue!");
+    }
+
+    // If start is at the beginning of the buffer, wrap around to the end
+    m_start = (m_start == 0) ? m_capacity - 1 : m_start - 1;
+    m_buffer[m_start] = data;
+    m_count++;
+}
+
+/********************************************
+** Function: dequeueBack()
+** Pre-conditions: None
+** Post-conditions: The newest data is removed from the buffer and returned, throws underflow_error if the buffer is empty
+********************************************/
+int Buffer::dequeueBack() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+
+    // If end is at the beginning of the buffer, wrap around to the end
+    m_end = (m_end == 0) ? m_capacity - 1 : m_end - 1;
+    m_count--;
+    return m_buffer[m_end];
+}
+
+/********************************************
+** Function: front()
+** Pre-conditions: None
+** Post-conditions: Returns the oldest data, throws underflow_error if the buffer is empty
+********************************************/
+int Buffer::front() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to peek!");
+    }
+    return m_buffer[m_start];
+}
+
+/********************************************
+** Function: back()
+** Pre-conditions: None
+** Post-conditions: Returns the newest data, throws underflow_error if the buffer is empty
+********************************************/
+int Buffer::back() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to peek!");
+    }
+    return m_buffer[(m_end == 0) ? m_capacity - 1 : m_end - 1];
+}
+
+/********************************************
+** Function: peekBatch(int n, BufferView& view, int skip)
+** Pre-conditions: view has room for the spans it already holds, skip is 0 or larger
+** Post-conditions: Up to n items after the skip oldest are appended to view as at most
+** two spans pointing into m_buffer, nothing is copied. Returns the number of items added.
+** The spans stay valid until the items are dequeued or consumed.
+********************************************/
+int Buffer::peekBatch(int n, BufferView& view, int skip) {
+    if (skip >= m_count) return 0;
+    int wanted = (n < m_count - skip) ? n : m_count - skip;
+    int added = 0;
+    int start = (m_start + skip) % m_capacity;
+
+    while (added < wanted && view.spanCount < MAX_VIEW_SPANS) {
+        // a span ends at the item count or at the end of the array, whichever is first
+        int length = wanted - added;
+        if (length > m_capacity - start) {
+            length = m_capacity - start;
+        }
+        view.spans[view.spanCount].data = m_buffer + start;
+        view.spans[view.spanCount].length = length;
+        view.spanCount++;
+        view.total += length;
+        added += length;
+        start = 0;
+    }
+    return added;
+}
+
+/********************************************
+** Function: consume(int k)
+** Pre-conditions: k is 0 or larger
+** Post-conditions: Up to k oldest items are removed. Returns the number removed.
+********************************************/
+int Buffer::consume(int k) {
+    int removed = (k < m_count) ? k : m_count;
+    if (removed <= 0) return 0;
+
+    m_start = (m_start + removed) % m_capacity;
+    m_count -= removed;
+    return removed;
+}
+
+/********************************************
+** Function: reserve(int n, BufferReservation& reservation)
+** Pre-conditions: reservation has room for the spans it already holds
+** Post-conditions: Up to n free slots after m_end are appended to reservation as at most
+** two spans pointing into m_buffer. Nothing is published until commit is called.
+** Returns the number of slots added.
+********************************************/
+int Buffer::reserve(int n, BufferReservation& reservation) {
+    int free = m_capacity - m_count;
+    int wanted = (n < free) ? n : free;
+    int added = 0;
+    int end = m_end;
+
+    while (added < wanted && reservation.spanCount < MAX_RESERVE_SPANS) {
+        // a span ends at the free space or at the end of the array, whichever is first
+        int length = wanted - added;
+        if (length > m_capacity - end) {
+            length = m_capacity - end;
+        }
+        reservation.spans[reservation.spanCount].data = m_buffer + end;
+        reservation.spans[reservation.spanCount].length = length;
+        reservation.spanCount++;
+        reservation.total += length;
+        added += length;
+        end = 0;
+    }
+    return added;
+}
+
+/********************************************
+** Function: commit(int k)
+** Pre-conditions: the k slots after m_end were reserved and written
+** Post-conditions: The k items are published as the newest items of the buffer,
+** throws overflow_error if k is larger than the free space
+********************************************/
+void Buffer::commit(int k) {
+    if (k <= 0) return;
+    if (k > m_capacity - m_count) {
+        throw std::overflow_error("Commit is larger than the free space!");
+    }
+    m_end = (m_end + k) % m_capacity;
+    m_count += k;
+}
+
+/********************************************
+** Function: setOverwrite(bool enabled)
+** Pre-conditions: None
+** Post-conditions: When enabled, enqueue on a full buffer overwrites the oldest item
+** instead of throwing overflow_error
+********************************************/
+void Buffer::setOverwrite(bool enabled) {
+    m_overwrite = enabled;
+}
+
+/********************************************
+** Function: dropped()
+** Pre-conditions: None
+** Post-conditions: Returns how many items were overwritten. Safe to call from a
+** thread other than the producer.
+********************************************/
+unsigned long long Buffer::dropped() {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+/********************************************
+** Function: zigzag(uint32_t delta), unzigzag(uint32_t code)
+** Pre-conditions: None
+** Post-conditions: Map signed deltas to unsigned codes so small negative deltas stay
+** small, and back again
+********************************************/
+static inline uint32_t zigzag(uint32_t delta) {
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static inline uint32_t unzigzag(uint32_t code) {
+    return (code >> 1) ^ (0u - (code & 1));
+}
+
+/********************************************
+** Function: compress()
+** Pre-conditions: None
+** Post-conditions: If the buffer holds items and the encoding is smaller than the items,
+** the items are replaced by the zigzag varint encoding of the difference between each
+** item and the one before it, and true is returned. Otherwise nothing changes.
+** While compressed, only count, capacity, empty, full, dump, copying and clear may be
+** used, everything else needs decompress first.
+********************************************/
+bool Buffer::compress() {
+    // borrowed storage cannot be swapped for an encoding
+    if (m_compressed || m_count == 0 || m_resource == nullptr) return false;
+
+    // first pass sizes the encoding so it can be allocated exactly
+    int bytes = 0;
+    uint32_t prev = 0;
+    int index = m_start;
+    for (int i = 0; i < m_count; i++) {
+        uint32_t code = zigzag((uint32_t)m_buffer[index] - prev);
+        prev = (uint32_t)m_buffer[index];
+        do {
+            bytes++;
+            code >>= 7;
+        } while (code != 0);
+        if (++index == m_capacity) index = 0;
+    }
+    if (bytes >= (int)sizeof(int) * m_count) return false;
+
+    unsigned char* packed = static_cast<unsigned char*>(m_resource->allocate(bytes, 1));
+    unsigned char* out = packed;
+    prev = 0;
+    index = m_start;
+    for (int i = 0; i < m_count; i++) {
+        uint32_t code = zigzag((uint32_t)m_buffer[index] - prev);
+        prev = (uint32_t)m_buffer[index];
+        while (code >= 0x80) {
+            *out++ = (unsigned char)(code | 0x80);
+            code >>= 7;
+        }
+        *out++ = (unsigned char)code;
+        if (++index == m_capacity) index = 0;
+    }
+
+    m_resource->deallocate(m_buffer, sizeof(int) * m_capacity, CACHE_LINE_SIZE);
+    m_buffer = reinterpret_cast<int*>(packed);
+    m_packedBytes = bytes;
+    m_compressed = true;
+    return true;
+}
+
+/********************************************
+** Function: decompress()
+** Pre-conditions: None
+** Post-conditions: If the buffer is compressed, the items are decoded into new storage
+** starting at index 0 and the encoding is freed
+********************************************/
+void Buffer::decompress() {
+    if (!m_compressed) return;
+
+    int* items = static_cast<int*>(m_resource->allocate(sizeof(int) * m_capacity, CACHE_LINE_SIZE));
+    decodeItems(items);
+
+    m_resource->deallocate(m_buffer, m_packedBytes, 1);
+    m_buffer = items;
+    m_start = 0;
+    m_end = m_count % m_capacity;
+    m_packedBytes = 0;
+    m_compressed = false;
+}
+
+/********************************************
+** Function: decodeItems(int* items)
+** Pre-conditions: the buffer is compressed, items has room for m_count items
+** Post-conditions: items holds the decoded items oldest first, the buffer is unchanged
+********************************************/
+void Buffer::decodeItems(int* items) const {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(m_buffer);
+    uint32_t prev = 0;
+    for (int i = 0; i < m_count; i++) {
+        uint32_t code = 0;
+        int shift = 0;
+        while (*in & 0x80) {
+            code |= (uint32_t)(*in++ & 0x7f) << shift;
+            shift += 7;
+        }
+        code |= (uint32_t)(*in++) << shift;
+        prev += unzigzag(code);
+        items[i] = (int)prev;
+    }
+}
+
+/********************************************
+** Function: compressed()
+** Pre-conditions: None
+** Post-conditions: Returns true if the items are held encoded
+********************************************/
+bool Buffer::compressed() {
+    return m_compressed;
+}
+
+/********************************************
+** Function: packedBytes()
+** Pre-conditions: None
+** Post-conditions: Returns the size of the encoding, 0 when the buffer is not compressed
+********************************************/
+int Buffer::packedBytes() {
+    return m_packedBytes;
+}
+
 /********************************************
 ** Function: Buffer(const Buffer& rhs)
 ** Pre-conditions: rhs is a Buffer object to be copied
-** Post-conditions: A new Buffer object is created as a copy of rhs
+** Post-conditions: A new Buffer object is created as a copy of rhs using the default
+** memory resource, like std::pmr containers do
+********************************************/
+Buffer::Buffer(const Buffer& rhs) : Buffer(rhs, std::pmr::get_default_resource()) {
+}
+
+/********************************************
+** Function: Buffer(const Buffer& rhs, std::pmr::memory_resource* resource)
+** Pre-conditions: rhs is a Buffer object to be copied, resource is not nullptr
+** Post-conditions: A new Buffer object is created as a copy of rhs, its storage comes from resource
+********************************************/
+Buffer::Buffer(const Buffer& rhs, std::pmr::memory_resource* resource) {
+    // the copy is not linked into any list
+    this->m_next = nullptr;
+    this->m_prev = nullptr;
+    this->m_resource = resource;
+    copyFrom(rhs);
+}
+
+/********************************************
+** Function: copyFrom(const Buffer& rhs)
+** Pre-conditions: this object owns no storage
+** Post-conditions: This object holds a deep copy of rhs's items in storage from m_resource
 ********************************************/
-Buffer::Buffer(const Buffer& rhs) {
+void Buffer::copyFrom(const Buffer& rhs) {
     // Copy the basic attributes
     this->m_start = rhs.m_start;
     this->m_count = rhs.m_count;
     this->m_end = rhs.m_end;
+    this->m_overwrite = rhs.m_overwrite;
+    this->m_dropped.store(rhs.m_dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->m_compressed = false;
+    this->m_packedBytes = 0;
 
-    if (rhs.m_capacity < 1) {
+    if (rhs.m_compressed) {
+        // copy the encoding as it is
+        this->m_capacity = rhs.m_capacity;
+        this->m_buffer = static_cast<int*>(m_resource->allocate(rhs.m_packedBytes, 1));
+        memcpy(this->m_buffer, rhs.m_buffer, rhs.m_packedBytes);
+        this->m_compressed = true;
+        this->m_packedBytes = rhs.m_packedBytes;
+    }
+    else if (rhs.m_capacity < 1) {
         // create a new empty buffer anyways
-        this->m_buffer = new int[0];
-        this->m_capacity = 0;
+        allocateStorage(0);
     } 
     else {
         // Allocate memory for the new buffer and copy the contents
-        this->m_capacity = rhs.m_capacity;
-        this->m_buffer = new int[m_capacity];
+        allocateStorage(rhs.m_capacity);
         for (int i = 0; i < m_capacity; i++) {
             this->m_buffer[i] = rhs.m_buffer[i];
         }
@@ -173,28 +558,31 @@ Buffer::Buffer(const Buffer& rhs) {
 /********************************************
 ** Function: operator=(const Buffer& rhs)
 ** Pre-conditions: rhs is a Buffer object to be assigned
-** Post-conditions: The current Buffer object is assigned the values of rhs
+** Post-conditions: The current Buffer object is assigned the values of rhs,
+** it keeps its own memory resource
 ********************************************/
 const Buffer& Buffer::operator=(const Buffer& rhs) {
     if (this == &rhs) return *this; // Self-assignment check
 
     // Free the existing buffer memory
-    delete[] m_buffer;
-
-    this->m_capacity = rhs.m_capacity;
-    this->m_start = rhs.m_start;
-    this->m_count = rhs.m_count;
-    this->m_end = rhs.m_end;
+    clear();
+    if (m_resource == nullptr) {
+        // the copy gets storage of its own
+        m_buffer = nullptr;
+        m_capacity = 0;
+        m_resource = std::pmr::get_default_resource();
+    }
 
     if (rhs.m_buffer == nullptr) {
-        this->m_buffer = nullptr;
+        this->m_start = rhs.m_start;
+        this->m_count = rhs.m_count;
+        this->m_end = rhs.m_end;
+        this->m_overwrite = rhs.m_overwrite;
+        this->m_dropped.store(rhs.m_dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
     } 
     else {
         // same as copy constructor
-        this->m_buffer = new int[m_capacity];
-        for (int i = 0; i < m_capacity; i++) {
-            this->m_buffer[i] = rhs.m_buffer[i];
-        }
+        copyFrom(rhs);
     }
     return *this;
 }
@@ -202,22 +590,120 @@ const Buffer& Buffer::operator=(const Buffer& rhs) {
 /********************************************
 ** Function: dump()
 ** Pre-conditions: None
-** Post-conditions: The contents of the buffer are printed to the console
+** Post-conditions: The contents of the buffer are printed to the console, which is flushed
 ********************************************/
 void Buffer::dump() {
-    int start = m_start;
-    int end = m_end;
-    int counter = 0;
-    cout << "Buffer size: " << m_capacity << " : ";
-    if (!empty()) {
-        while (counter < m_count) {
-            cout << m_buffer[start] << "[" << start << "]" << " ";
-            start = (start + 1) % m_capacity;
-            counter++;
+    ExportWriter out(cout, ExportWriter::plainCapacity(1, m_count));
+    exportTo(out, EXPORT_PLAIN);
+    out.flush();
+    cout.flush();
+}
+
+/********************************************
+** Function: exportTo(ExportWriter& out, ExportFormat format)
+** Pre-conditions: None
+** Post-conditions: The buffer is written to out as a complete document: the dump line,
+** a CSV header and rows, or a JSON object with a one element segments array. The
+** buffer is unchanged, compressed items are decoded into scratch memory.
+********************************************/
+void Buffer::exportTo(ExportWriter& out, ExportFormat format) {
+    if (format == EXPORT_CSV) {
+        out.append("segment,capacity,count,compressed,position,value\n");
+        exportSegment(out, format, 0);
+    }
+    else if (format == EXPORT_JSON) {
+        out.append("{\"count\":");
+        out.appendInt(m_count);
+        out.append(",\"segments\":[");
+        exportSegment(out, format, 0);
+        out.append("]}\n");
+    }
+    else {
+        exportSegment(out, format, 0);
+    }
+}
+
+/********************************************
+** Function: exportSegment(ExportWriter& out, ExportFormat format, int segment)
+** Pre-conditions: None
+** Post-conditions: This buffer's part of an export is written to out, numbered segment.
+** Plain is the dump line with items and their slots; CSV is one row per item, or one
+** row without position and value for an empty buffer; JSON is one object.
+********************************************/
+void Buffer::exportSegment(ExportWriter& out, ExportFormat format, int segment) {
+    if (format == EXPORT_PLAIN) {
+        out.append("Buffer size: ");
+        out.appendInt(m_capacity);
+        out.append(" : ");
+        if (m_compressed) {
+            out.appendInt(m_count);
+            out.append(" items compressed into ");
+            out.appendInt(m_packedBytes);
+            out.append(" bytes\n");
+        }
+        else if (!empty()) {
+            int index = m_start;
+            for (int i = 0; i < m_count; i++) {
+                out.appendInt(m_buffer[index]);
+                out.append('[');
+                out.appendInt(index);
+                out.append("] ", 2);
+                if (++index == m_capacity) index = 0;
+            }
+            out.append('\n');
+        }
+        else {
+            out.append("Buffer is empty!\n");
+        }
+        return;
+    }
+
+    // CSV and JSON list the items oldest first, so compressed ones are decoded
+    int* decoded = nullptr;
+    if (m_compressed) {
+        decoded = new int[m_count];
+        decodeItems(decoded);
+    }
+
+    if (format == EXPORT_CSV) {
+        if (m_count == 0) {
+            out.appendInt(segment);
+            out.append(',');
+            out.appendInt(m_capacity);
+            out.append(",0,0,,\n");
+        }
+        int index = m_start;
+        for (int i = 0; i < m_count; i++) {
+            out.appendInt(segment);
+            out.append(',');
+            out.appendInt(m_capacity);
+            out.append(',');
+            out.appendInt(m_count);
+            out.append(m_compressed ? ",1," : ",0,", 3);
+            out.appendInt(i);
+            out.append(',');
+            out.appendInt(m_compressed ? decoded[i] : m_buffer[index]);
+            out.append('\n');
+            if (++index == m_capacity) index = 0;
         }
-        cout << endl;
     }
     else {
-        cout << "Buffer is empty!" << endl;
+        out.append("{\"segment\":");
+        out.appendInt(segment);
+        out.append(",\"capacity\":");
+        out.appendInt(m_capacity);
+        out.append(",\"count\":");
+        out.appendInt(m_count);
+        out.append(m_compressed ? ",\"compressed\":true,\"packedBytes\":" : ",\"compressed\":false,\"packedBytes\":");
+        out.appendInt(m_packedBytes);
+        out.append(",\"items\":[");
+        int index = m_start;
+        for (int i = 0; i < m_count; i++) {
+            if (i > 0) out.append(',');
+            out.appendInt(m_compressed ? decoded[i] : m_buffer[index]);
+            if (++index == m_capacity) index = 0;
+        }
+        out.append("]}");
     }
-}
\ No newline at end of file
+    delete[] decoded;
+}
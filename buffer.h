@@ -16,6 +16,9 @@
 #define BUFFER_H
 #include <stdexcept>
 #include <iostream>
+#include <memory_resource>
+#include <atomic>
+#include "exportwriter.h"
 using namespace std;
 class Grader;//this class is for grading purposes, no need to do anything
 //the following is your tester class, you add your test functions in this class
@@ -23,35 +26,138 @@ class Grader;//this class is for grading purposes, no need to do anything
 class Tester;
 //forward declaration, BufferList will be a friend of Buffer class
 class BufferList;
-class Buffer{
+class BroadcastBufferList;
+const int CACHE_LINE_SIZE = 64;     // buffer headers and storage start on a cache line
+const int MAX_VIEW_SPANS = 8;   // most contiguous ranges a BufferView can describe
+struct BufferSpan{
+    const int *data;        // first item of a contiguous range inside a buffer
+    int length;             // number of items in the range
+};
+struct BufferView{
+    BufferSpan spans[MAX_VIEW_SPANS]; // contiguous ranges, oldest first
+    int spanCount;          // number of spans in use
+    int total;              // number of items described by all spans
+};
+struct BufferWriteSpan{
+    int *data;              // first writable slot of a contiguous range inside a buffer
+    int length;             // number of writable slots in the range
+};
+const int MAX_RESERVE_SPANS = 3; // free space of the cursor (two ranges) plus one new buffer
+struct BufferReservation{
+    BufferWriteSpan spans[MAX_RESERVE_SPANS]; // writable ranges, in the order they are committed
+    int spanCount;          // number of spans in use
+    int total;              // number of writable slots described by all spans
+};
+class alignas(CACHE_LINE_SIZE) Buffer{
     public:
     friend class Grader;//Grader will have access to private members of Buffer
     friend class Tester;//Tester will have access to private members of Buffer
     friend class BufferList;//BufferList will have access to private members of Buffer
-    Buffer(int capacity);       //constructor
+    friend class BroadcastBufferList;//readers of a BroadcastBufferList read items in place
+    Buffer(int capacity, std::pmr::memory_resource * resource = std::pmr::get_default_resource()); //constructor
     ~Buffer();                  //destructor
-    Buffer(const Buffer & rhs); //copy constructor
+    Buffer(const Buffer & rhs); //copy constructor, the copy uses the default memory resource
+    Buffer(const Buffer & rhs, std::pmr::memory_resource * resource); //copy constructor using resource
+    Buffer(int * storage, int capacity); //constructor over storage the buffer does not own, it never allocates
     const Buffer & operator=(const Buffer & rhs);// overloaded assignment operator
     void enqueue(int data); // inserts at the end
     int dequeue();          // removes from start
+    void enqueueFront(int data); // inserts before the start
+    int dequeueBack();      // removes from the end
+    int front();            // returns the oldest item without removing it
+    int back();             // returns the newest item without removing it
+    int peekBatch(int n, BufferView & view, int skip = 0); // appends up to n items after the skip oldest to view, returns how many
+    int consume(int k);     // removes up to k oldest items, returns how many
+    int reserve(int n, BufferReservation & reservation); // appends up to n free slots after the end, returns how many
+    void commit(int k);     // publishes k items written into reserved slots
+    void setOverwrite(bool enabled); // when full, enqueue overwrites the oldest item instead of throwing
+    unsigned long long dropped();    // number of items overwritten so far
+    bool compress();        // replaces the items with a delta varint encoding, returns true if it saved space
+    void decompress();      // restores the items from their encoding
+    bool compressed();      // returns true if the items are held encoded
+    int packedBytes();      // size of the encoding, 0 when not compressed
     void clear();           // deallocate memory
     bool empty();           // returns true if buffer holds no items
     bool full();            // returns true if no space left in buffer
     int count();            // returns number of items currently held in the buffer
     int capacity();         // returns maximum number of items this buffer can hold
-    void dump();            // prints out the contents, for debugging purposes
+    void dump();            // prints out the contents, for debugging purposes, a plain export to cout
+    void exportTo(ExportWriter & out, ExportFormat format); // writes the items and metadata as text
+    template <typename Pred>
+    int removeIf(Pred pred); // removes every item matching pred, keeps the rest in order
 
 
     private:
-    int *m_buffer ;         // pointer to dynamically allocated array for buffer 
+    // the hot fields fit in the first cache line of the object
+    int *m_buffer ;         // pointer to dynamically allocated array for buffer, cache line aligned,
+                            // holds m_packedBytes of encoded items instead while m_compressed is set
     int m_capacity ;        // length of the allocated space pointed by m_buffer
     int m_count ;           // current number of items in the buffer
     int m_start ;           // index of the first (oldest) item in the buffer
     int m_end ;             // index of the last (newest) item in the buffer
     Buffer* m_next;         // pointer to the next buffer in a linked list
+    Buffer* m_prev;         // pointer to the previous buffer in a linked list
+    std::pmr::memory_resource *m_resource; // where m_buffer is allocated from, nullptr if m_buffer is borrowed
+    bool m_overwrite;       // whether a full buffer overwrites its oldest item
+    bool m_compressed;      // whether m_buffer holds the encoding instead of the items
+    int m_packedBytes;      // size of the encoding pointed to by m_buffer
+    std::atomic<unsigned long long> m_dropped; // items overwritten, only the producer writes it
 
     // ***************************************************
     // Any private helper functions must be delared here!
     // ***************************************************
+    void allocateStorage(int capacity);  // allocates m_buffer from m_resource
+    void copyFrom(const Buffer & rhs);   // copies rhs's items into freshly allocated storage
+    void decodeItems(int * items) const; // decodes the m_count compressed items into items
+    void exportSegment(ExportWriter & out, ExportFormat format, int segment); // one buffer's part of an export
 };
+
+/********************************************
+** Function: removeIf(Pred pred)
+** Pre-conditions: pred is callable as bool pred(int)
+** Post-conditions: A compressed buffer is decoded first. Items for which pred returns
+** true are removed. Survivors keep their order and are slid toward m_start in place.
+** Returns the number of items removed.
+********************************************/
+template <typename Pred>
+int Buffer::removeIf(Pred pred) {
+    if (empty()) return 0;
+    decompress();
+
+    // the items are two contiguous runs, m_start to the end of the array, then from 0
+    int first = m_capacity - m_start;
+    if (first > m_count) first = m_count;
+    int second = m_count - first;
+    int write = m_start;
+
+    // branch-free compaction, the write index only moves past kept items
+    for (int read = m_start; read < m_start + first; read++) {
+        int data = m_buffer[read];
+        m_buffer[write] = data;
+        write += pred(data) ? 0 : 1;
+    }
+
+    // the wrapped run first fills the slots freed at the end of the array, then goes from 0
+    int read = 0;
+    for (; read < second && write < m_capacity; read++) {
+        int data = m_buffer[read];
+        m_buffer[write] = data;
+        write += pred(data) ? 0 : 1;
+    }
+    int kept = write - m_start;
+    if (write == m_capacity) {
+        write = 0;
+        for (; read < second; read++) {
+            int data = m_buffer[read];
+            m_buffer[write] = data;
+            write += pred(data) ? 0 : 1;
+        }
+        kept += write;
+    }
+
+    int removed = m_count - kept;
+    m_count = kept;
+    m_end = write;
+    return removed;
+}
 #endif
\ No newline at end of file
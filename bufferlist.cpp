@@ -7,24 +7,46 @@
 ** E-mail: DanielWu1510@tamu.edu
 **
 ** This file contains the implementation for the BufferList class.
-** This class is a circular linked list of Buffer objects.
+** This class is a circular doubly linked list of Buffer objects.
+** Items can also be added at the front and removed from the back, so it works as a deque.
 ** Every object is a circular buffer that stores integer values. The data structure has a FIFO structure.
 ** Everytime the buffer is full, a new buffer is created with twice the capacity of the previous buffer.
 ** Everytime the buffer is empty, the buffer is deleted.
+** With compression on, full buffers between the front and the cursor are held encoded.
+** The front and the cursor are always decoded, so enqueue and dequeue never see an encoding.
 ******************************************************************************************/
 
 
 #include "bufferlist.h"
+#include "segmentarena.h"
+#include "sizeclasses.h"
 #include <stdexcept>
+#include <new>
 
 /********************************************
-** Function: BufferList(int minBufCapacity)
-** Pre-conditions: minBufCapacity is an integer larger than 0
-** Post-conditions: A BufferList object is created on the heap with a Buffer object
+** Function: BufferList(int minBufCapacity, std::pmr::memory_resource* resource)
+** Pre-conditions: minBufCapacity is an integer larger than 0, resource is not nullptr
+** Post-conditions: A BufferList object is created with its inline buffer and nothing
+** on the heap. Every buffer added later and its storage comes from resource.
 ********************************************/
-BufferList::BufferList(int minBufCapacity) {
-    
+BufferList::BufferList(int minBufCapacity, std::pmr::memory_resource* resource)
+    : m_inline(m_inlineStorage, INLINE_CAPACITY) {
+
     m_listSize = 0;
+    m_reserved = nullptr;
+    m_reservedCount = 0;
+    m_reservedInCursor = 0;
+    m_resource = resource;
+    m_prefetch = true;
+    m_sizeClasses = false;
+    m_bounded = false;
+    m_compress = false;
+    m_tracker = nullptr;
+
+    SegmentArena* arena = dynamic_cast<SegmentArena*>(m_resource);
+    if (arena != nullptr) {
+        arena->attach();
+    }
 
     if (minBufCapacity < 1) {
         // set to default value of 10
@@ -34,10 +56,8 @@ BufferList::BufferList(int minBufCapacity) {
         m_minBufCapacity = minBufCapacity;
     }
 
-    // create a new buffer with the min capacity
-    m_cursor = new Buffer(m_minBufCapacity);
-    m_cursor->m_next = m_cursor;
-    m_listSize += 1;
+    // the first items go to the inline buffer, the heap is only used once it fills
+    resetToInline();
 }
 
 /********************************************
@@ -46,15 +66,48 @@ BufferList::BufferList(int minBufCapacity) {
 ** Post-conditions: the clear function is called to deallocate all memory
 ********************************************/
 BufferList::~BufferList() {
+    // the tracker may already be gone, and clear must not rebuild an overwriting ring
+    m_tracker = nullptr;
+    m_bounded = false;
     clear();
+
+    SegmentArena* arena = dynamic_cast<SegmentArena*>(m_resource);
+    if (arena != nullptr) {
+        arena->detach();
+    }
 }
 
 /********************************************
 ** Function: clear()
 ** Pre-conditions: None
-** Post-conditions: All buffers in the list are deallocated and memory is freed
+** Post-conditions: All buffers in the list are deallocated and memory is freed.
+** If the list is the only user of a SegmentArena, the whole arena is released at
+** once instead of deleting each buffer. The empty inline buffer is left in the list,
+** or an empty ring of the same capacity if the list overwrites. A tracker is reset.
 ********************************************/
 void BufferList::clear() {
+    if (m_tracker != nullptr) {
+        m_tracker->reset();
+    }
+    // an overwriting list stays bounded, it only loses its items
+    int ring = (m_bounded && m_cursor != nullptr) ? m_cursor->capacity() : 0;
+
+    SegmentArena* arena = dynamic_cast<SegmentArena*>(m_resource);
+    if (arena != nullptr && arena->users() == 1) {
+        arena->release();
+        m_reserved = nullptr;
+        m_reservedCount = 0;
+        m_reservedInCursor = 0;
+        resetToInline();
+        if (ring > 0) {
+            setOverwriteCapacity(ring);
+        }
+        return;
+    }
+
+    // drop an outstanding reservation
+    dropReservation();
+
     if (m_cursor == nullptr) return; // Added check for nullptr
 
     // set both pointers to the beginning of the linked list
@@ -63,17 +116,28 @@ void BufferList::clear() {
 
     // iterate through the linked list and delete each node
     while (bufferDelete != m_cursor) {
-        bufferDelete->clear();
         bufferDelete = bufferDelete->m_next;
-        delete nodeDelete;
+        destroySegment(nodeDelete);
         nodeDelete = bufferDelete;
     }
 
     // clear the cursor
-    m_cursor->clear();
-    delete m_cursor;
-    m_cursor = nullptr;
-    m_listSize = 0;
+    destroySegment(m_cursor);
+    resetToInline();
+    if (ring > 0) {
+        setOverwriteCapacity(ring);
+    }
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if the list holds no items. Buffers are deleted as
+** soon as they drain, so the list is empty only when one empty buffer is left.
+********************************************/
+bool BufferList::empty() {
+    if (m_cursor == nullptr) return true;
+    return m_listSize == 1 && m_cursor->empty();
 }
 
 /********************************************
@@ -82,25 +146,31 @@ void BufferList::clear() {
 ** Post-conditions: data is added to the buffer, a new buffer is created if the current buffer is full
 ********************************************/
 void BufferList::enqueue(const int& data) {
+    if (m_tracker != nullptr) {
+        // a full overwriting buffer drops its oldest item
+        if (m_cursor->m_overwrite && m_cursor->full()) {
+            m_tracker->popped(m_cursor->front());
+        }
+        m_tracker->pushed(data);
+    }
+
     try {
         // try to enqueue the data with the current cursor
         this->m_cursor->enqueue(data);
     } 
     catch (const std::overflow_error& e) {
-        int newSize = (this->m_cursor->capacity()) * INCREASE_FACTOR;
-        if (newSize > MAX_FACTOR * m_minBufCapacity) {
-            newSize = m_minBufCapacity;
-        }
-
         // create a new buffer with the calculated capacity
-        Buffer* newBuffer = new Buffer(newSize);
-        newBuffer->m_next = this->m_cursor->m_next;
-        this->m_cursor->m_next = newBuffer;
+        Buffer* newBuffer = createSegment(growthCapacity(this->m_cursor));
+        linkAfter(this->m_cursor, newBuffer);
         this->m_cursor = newBuffer;
 
         // enqueue the data with the new cursor
         this->m_cursor->enqueue(data);
-        this->m_listSize += 1;
+
+        // the old cursor is full and now sits behind the cursor
+        if (m_compress) {
+            compressIfCold(newBuffer->m_prev);
+        }
     }
 }
 
@@ -114,19 +184,22 @@ int BufferList::dequeue() {
         throw std::underflow_error("Nothing to dequeue!");
     }
     try {
-        int data = this->m_cursor->m_next->dequeue();
+        Buffer* front = this->m_cursor->m_next;
+        int data = front->dequeue();
 
-        // Check if the buffer is empty after dequeue
-        if (this->m_cursor->m_next->empty() && m_listSize > 1) {
-            // create a temporary pointer to the second buffer
-            Buffer* temp = m_cursor->m_next->m_next;
+        // warm up the next buffer while the last cache line of this one is read
+        if (m_prefetch && front->m_count < PREFETCH_LEAD && m_listSize > 1) {
+            prefetchSegment(front->m_next);
+        }
 
-            // delete the first buffer
-            delete m_cursor->m_next;
-            m_cursor->m_next = temp;
-            m_listSize -= 1;
+        // Check if the buffer is empty after dequeue, delete the first buffer if so
+        if (front->empty() && m_listSize > 1) {
+            unlinkSegment(front);
         }
 
+        if (m_tracker != nullptr) {
+            m_tracker->popped(data);
+        }
         return data;
     } 
     catch (const std::underflow_error& e) {
@@ -134,14 +207,12 @@ int BufferList::dequeue() {
             throw std::underflow_error("Nothing to dequeue! Only one buffer in the list.");
         }
 
-        // create a temporary pointer to the second buffer
-        Buffer* temp = m_cursor->m_next->m_next;
-
         // delete the first buffer
-        delete m_cursor->m_next;
-        m_cursor->m_next = temp;
-        m_listSize -= 1;
+        unlinkSegment(m_cursor->m_next);
         int data = this->m_cursor->m_next->dequeue();
+        if (m_tracker != nullptr) {
+            m_tracker->popped(data);
+        }
         return data;
     }
 }
@@ -149,11 +220,58 @@ int BufferList::dequeue() {
 /********************************************
 ** Function: BufferList(const BufferList& rhs)
 ** Pre-conditions: rhs is a BufferList object to be copied
-** Post-conditions: A new BufferList object is created as a copy of rhs
+** Post-conditions: A new BufferList object is created as a copy of rhs using the
+** default memory resource, like std::pmr containers do
 ********************************************/
-BufferList::BufferList(const BufferList& rhs) {
+BufferList::BufferList(const BufferList& rhs) : m_inline(m_inlineStorage, INLINE_CAPACITY) {
+    // reservations are not copied
+    this->m_reserved = nullptr;
+    this->m_reservedCount = 0;
+    this->m_reservedInCursor = 0;
+    this->m_resource = std::pmr::get_default_resource();
+    this->m_prefetch = rhs.m_prefetch;
+    this->m_sizeClasses = rhs.m_sizeClasses;
+    this->m_bounded = rhs.m_bounded;
+    this->m_compress = rhs.m_compress;
+    this->m_tracker = nullptr;      // a tracker follows one list
+    this->m_listSize = 0;
+    this->m_minBufCapacity = rhs.m_minBufCapacity;
+
+    copyList(rhs);
+}
+
+/********************************************
+** Function: operator=(const BufferList& rhs)
+** Pre-conditions: rhs is a BufferList object to be assigned
+** Post-conditions: The current BufferList object is assigned the values and modes of
+** rhs, it keeps its own memory resource and its tracker, which is told about the new items
+********************************************/
+const BufferList& BufferList::operator=(const BufferList& rhs) {
+    if (this == &rhs) return *this; // Self-assignment check
+
+    this->m_bounded = false;    // clear would rebuild this list's ring
+    this->clear();
+    this->m_prefetch = rhs.m_prefetch;
+    this->m_sizeClasses = rhs.m_sizeClasses;
+    this->m_bounded = rhs.m_bounded;
+    this->m_compress = rhs.m_compress;
+    copyList(rhs);
+    retrack();
+
+    return *this;
+}
+
+/********************************************
+** Function: copyList(const BufferList& rhs)
+** Pre-conditions: this list holds no buffers but its empty inline buffer
+** Post-conditions: This list holds deep copies of rhs's buffers, allocated from m_resource.
+** The items of rhs's inline buffer are copied into this list's inline buffer.
+********************************************/
+void BufferList::copyList(const BufferList& rhs) {
+    m_inline.m_next = nullptr;
+    m_inline.m_prev = nullptr;
     if (rhs.m_cursor == nullptr) {
-        this->m_cursor = nullptr;
+        resetToInline();
         return;
     }
 
@@ -163,7 +281,7 @@ BufferList::BufferList(const BufferList& rhs) {
 
     // create a pointer to the first buffer in the list
     Buffer* RHScurrent = rhs.m_cursor->m_next;
-    m_cursor = new Buffer(*RHScurrent);
+    m_cursor = (RHScurrent == &rhs.m_inline) ? copyInline(*RHScurrent) : copySegment(*RHScurrent);
 
     // create a pointer to the first buffer in the new list, saves it for circular structure
     Buffer* LHSstart = m_cursor;
@@ -173,62 +291,927 @@ BufferList::BufferList(const BufferList& rhs) {
 
     while (RHScurrent != rhs.m_cursor) {
         RHScurrent = RHScurrent->m_next;
-        m_cursor->m_next = new Buffer(*RHScurrent);
+        m_cursor->m_next = (RHScurrent == &rhs.m_inline) ? copyInline(*RHScurrent) : copySegment(*RHScurrent);
         m_cursor = m_cursor->m_next;
         LHSprev->m_next = m_cursor;
+        m_cursor->m_prev = LHSprev;
         LHSprev = LHSprev->m_next;
     }
 
     // Maintain circular structure
     m_cursor->m_next = LHSstart;
+    LHSstart->m_prev = m_cursor;
 }
 
 /********************************************
-** Function: operator=(const BufferList& rhs)
-** Pre-conditions: rhs is a BufferList object to be assigned
-** Post-conditions: The current BufferList object is assigned the values of rhs
+** Function: dump()
+** Pre-conditions: None
+** Post-conditions: The contents of the buffer list are printed to the console, which is
+** flushed
 ********************************************/
-const BufferList& BufferList::operator=(const BufferList& rhs) {
-    if (this == &rhs) return *this; // Self-assignment check
+void BufferList::dump() {
+    ExportWriter out(cout, ExportWriter::plainCapacity(m_listSize, count()));
+    exportTo(out, EXPORT_PLAIN);
+    out.flush();
+    cout.flush();
+}
 
-    this->clear();
+/********************************************
+** Function: exportTo(ExportWriter& out, ExportFormat format)
+** Pre-conditions: None
+** Post-conditions: Every buffer, front first, is written to out as one document: the
+** dump lines, a CSV header and one row per item with its buffer's metadata, or a JSON
+** object with the item count and a segments array. Nothing is flushed before out's
+** buffer fills, and the list is unchanged.
+********************************************/
+void BufferList::exportTo(ExportWriter& out, ExportFormat format) {
+    if (format == EXPORT_CSV) {
+        out.append("segment,capacity,count,compressed,position,value\n");
+    }
+    else if (format == EXPORT_JSON) {
+        out.append("{\"count\":");
+        out.appendInt(count());
+        out.append(",\"segments\":[");
+    }
 
-    if (rhs.m_cursor == nullptr) {
-        this->m_cursor = nullptr;
-        return *this;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        if (format == EXPORT_JSON && i > 0) {
+            out.append(',');
+        }
+        temp->exportSegment(out, format, i);
+        temp = temp->m_next;
     }
 
-    // same as copy constructor
-    this->m_listSize = rhs.m_listSize;
-    this->m_minBufCapacity = rhs.m_minBufCapacity;
+    if (format == EXPORT_JSON) {
+        out.append("]}\n");
+    }
+}
 
-    Buffer* RHScurrent = rhs.m_cursor->m_next;
-    m_cursor = new Buffer(*RHScurrent);
-    Buffer* LHSstart = m_cursor;
-    Buffer* LHSprev = m_cursor;
+/********************************************
+** Function: pruneEmptySegments()
+** Pre-conditions: m_cursor is not nullptr
+** Post-conditions: Empty buffers are unlinked and deleted, m_listSize is updated.
+** If every buffer is empty, exactly one is kept. The cursor moves back to its
+** predecessor when the cursor itself is removed.
+********************************************/
+void BufferList::pruneEmptySegments() {
+    Buffer* current = m_cursor->m_next;
+    int segments = m_listSize;
 
-    while (RHScurrent != rhs.m_cursor) {
-        RHScurrent = RHScurrent->m_next;
-        m_cursor->m_next = new Buffer(*RHScurrent);
-        m_cursor = m_cursor->m_next;
-        LHSprev->m_next = m_cursor;
-        LHSprev = LHSprev->m_next;
+    for (int i = 0; i < segments && m_listSize > 1; i++) {
+        Buffer* next = current->m_next;
+        if (current->empty()) {
+            unlinkSegment(current);
+        }
+        current = next;
     }
+}
 
-    m_cursor->m_next = LHSstart;
+/********************************************
+** Function: nextCapacity(int capacity)
+** Pre-conditions: capacity is the capacity of the buffer being grown from
+** Post-conditions: Returns capacity times INCREASE_FACTOR, starting over at
+** m_minBufCapacity once MAX_FACTOR times the min capacity would be exceeded
+********************************************/
+int BufferList::nextCapacity(int capacity) {
+    int newSize = capacity * INCREASE_FACTOR;
+    if (newSize > MAX_FACTOR * m_minBufCapacity) {
+        newSize = m_minBufCapacity;
+    }
+    return newSize;
+}
 
-    return *this;
+/********************************************
+** Function: linkAfter(Buffer* position, Buffer* segment)
+** Pre-conditions: position is in the list, segment is not
+** Post-conditions: segment is linked in right after position in both directions
+** and m_listSize is updated. The cursor is not moved.
+********************************************/
+void BufferList::linkAfter(Buffer* position, Buffer* segment) {
+    segment->m_next = position->m_next;
+    segment->m_prev = position;
+    position->m_next->m_prev = segment;
+    position->m_next = segment;
+    m_listSize += 1;
 }
 
 /********************************************
-** Function: dump()
+** Function: unlinkSegment(Buffer* segment)
+** Pre-conditions: segment is in the list and is not the only buffer
+** Post-conditions: segment is unlinked and deleted, see detachSegment
+********************************************/
+void BufferList::unlinkSegment(Buffer* segment) {
+    detachSegment(segment);
+    destroySegment(segment);
+}
+
+/********************************************
+** Function: detachSegment(Buffer* segment)
+** Pre-conditions: segment is in the list and is not the only buffer
+** Post-conditions: segment is unlinked but not deleted, m_listSize is updated.
+** If segment was the cursor, the cursor moves to its predecessor. A buffer that
+** becomes the front or the cursor is decoded.
+********************************************/
+void BufferList::detachSegment(Buffer* segment) {
+    segment->m_prev->m_next = segment->m_next;
+    segment->m_next->m_prev = segment->m_prev;
+    if (segment == m_cursor) {
+        m_cursor = segment->m_prev;
+    }
+    segment->m_next = nullptr;
+    segment->m_prev = nullptr;
+    m_listSize -= 1;
+
+    m_cursor->decompress();
+    m_cursor->m_next->decompress();
+}
+
+/********************************************
+** Function: pushFront(const int& data)
+** Pre-conditions: data is an integer to be added to the list
+** Post-conditions: data is added in front of the oldest item so it is dequeued next.
+** A new front buffer is linked in between the cursor and the old front if needed.
+** An outstanding reserve is cancelled. A tracker only follows FIFO order, so it is
+** rebuilt, O(n).
+********************************************/
+void BufferList::pushFront(const int& data) {
+    // the new item may take a free slot that reserve handed out
+    dropReservation();
+
+    Buffer* front = m_cursor->m_next;
+    if (front->full()) {
+        if (m_bounded) {
+            throw std::overflow_error("No space for pushFront! The list is bounded.");
+        }
+        Buffer* newBuffer = createSegment(growthCapacity(front));
+        linkAfter(m_cursor, newBuffer);
+        front = newBuffer;
+    }
+    front->enqueueFront(data);
+    retrack();
+}
+
+/********************************************
+** Function: popBack()
 ** Pre-conditions: None
-** Post-conditions: The contents of the buffer list are printed to the console
+** Post-conditions: The newest data is removed and returned, the cursor buffer is deleted
+** if it becomes empty and the cursor moves back. Throws underflow_error if the list is empty.
+** An outstanding reserve is cancelled. A tracker is rebuilt, O(n).
 ********************************************/
-void BufferList::dump() {
+int BufferList::popBack() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+
+    // the cursor's end moves back, so reserved slots would no longer follow it
+    dropReservation();
+
+    int data = m_cursor->dequeueBack();
+    if (m_cursor->empty() && m_listSize > 1) {
+        unlinkSegment(m_cursor);
+    }
+    retrack();
+    return data;
+}
+
+/********************************************
+** Function: front()
+** Pre-conditions: None
+** Post-conditions: Returns the oldest data, throws underflow_error if the list is empty
+********************************************/
+int BufferList::front() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to peek!");
+    }
+    return m_cursor->m_next->front();
+}
+
+/********************************************
+** Function: back()
+** Pre-conditions: None
+** Post-conditions: Returns the newest data, throws underflow_error if the list is empty
+********************************************/
+int BufferList::back() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to peek!");
+    }
+    return m_cursor->back();
+}
+
+/********************************************
+** Function: peekBatch(int n, int skip)
+** Pre-conditions: skip is 0 or larger
+** Post-conditions: Returns a view of up to n items after the skip oldest as spans pointing
+** into the live buffers, oldest first, decoding compressed buffers it reaches. Skipped
+** buffers are passed over whole and stay encoded. A view holds at most MAX_VIEW_SPANS
+** spans, so it may describe fewer than n items; view.total tells how many, and calling
+** again with skip raised by view.total continues where it stopped. Spans are invalidated
+** by dequeue, consume, popBack or clear.
+********************************************/
+BufferView BufferList::peekBatch(int n, int skip) {
+    BufferView view;
+    view.spanCount = 0;
+    view.total = 0;
+    if (m_cursor == nullptr) return view;
+
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize && view.total < n && view.spanCount < MAX_VIEW_SPANS; i++) {
+        if (skip >= temp->m_count) {
+            skip -= temp->m_count;
+        }
+        else {
+            temp->decompress();
+            temp->peekBatch(n - view.total, view, skip);
+            skip = 0;
+        }
+        temp = temp->m_next;
+    }
+    return view;
+}
+
+/********************************************
+** Function: consume(int k)
+** Pre-conditions: k is 0 or larger
+** Post-conditions: Up to k oldest items are removed, buffers that drain are deleted.
+** Returns the number of items removed.
+********************************************/
+int BufferList::consume(int k) {
+    int removed = 0;
+    while (removed < k && !empty()) {
+        if (m_tracker != nullptr) {
+            int leaving = m_cursor->m_next->count();
+            trackItems(m_cursor->m_next, 0, (leaving < k - removed) ? leaving : k - removed, m_tracker, nullptr);
+        }
+        removed += m_cursor->m_next->consume(k - removed);
+        if (m_cursor->m_next->empty() && m_listSize > 1) {
+            unlinkSegment(m_cursor->m_next);
+        }
+    }
+    return removed;
+}
+
+/********************************************
+** Function: reserve(int n)
+** Pre-conditions: n is 1 or larger
+** Post-conditions: Returns writable spans for up to n new items, first the free space
+** after the cursor's m_end, then a new buffer if that is not enough. A bounded list
+** only hands out its free space. The new buffer is
+** at least nextCapacity of the cursor and large enough for the rest of n. Nothing is
+** visible to dequeue until commit is called, and no other producer call may come in
+** between. dequeue and consume may; pushFront, popBack and removeIf cancel the
+** reservation. A second reserve replaces the first.
+********************************************/
+BufferReservation BufferList::reserve(int n) {
+    BufferReservation reservation;
+    reservation.spanCount = 0;
+    reservation.total = 0;
+
+    dropReservation();
+
+    m_reservedInCursor = m_cursor->reserve(n, reservation);
+    int rest = n - reservation.total;
+    if (rest > 0 && !m_bounded) {
+        int newSize = growthCapacity(m_cursor);
+        if (newSize < rest) {
+            newSize = rest;
+        }
+        m_reserved = createSegment(newSize);
+        m_reserved->reserve(rest, reservation);
+    }
+
+    m_reservedCount = reservation.total;
+    return reservation;
+}
+
+/********************************************
+** Function: commit(int k)
+** Pre-conditions: reserve was called and the first k slots were written
+** Post-conditions: The first k reserved items become the newest items of the list.
+** The slots reserve handed out in the cursor are filled first, even if dequeues have
+** freed more space there since. The reserved buffer is linked in as the new cursor
+** only if k reaches into it, otherwise it is deleted; an old cursor drained since
+** reserve is then deleted, so the front is never empty. Throws out_of_range if k is
+** larger than the reservation.
+********************************************/
+void BufferList::commit(int k) {
+    if (k < 0 || k > m_reservedCount) {
+        throw std::out_of_range("Commit is larger than the reservation!");
+    }
+
+    int inCursor = (k < m_reservedInCursor) ? k : m_reservedInCursor;
+    m_cursor->commit(inCursor);
+    if (m_tracker != nullptr) {
+        trackItems(m_cursor, m_cursor->count() - inCursor, inCursor, nullptr, m_tracker);
+    }
+
+    if (k > inCursor) {
+        Buffer* previous = m_cursor;
+        linkAfter(m_cursor, m_reserved);
+        m_cursor = m_reserved;
+        m_cursor->commit(k - inCursor);
+        if (m_tracker != nullptr) {
+            trackItems(m_cursor, 0, k - inCursor, nullptr, m_tracker);
+        }
+        if (previous->empty()) {
+            // the consumer drained the old cursor after reserve
+            unlinkSegment(previous);
+        }
+        else if (m_compress) {
+            compressIfCold(previous);
+        }
+    }
+    else if (m_reserved != nullptr) {
+        destroySegment(m_reserved);
+    }
+    m_reserved = nullptr;
+    m_reservedCount = 0;
+    m_reservedInCursor = 0;
+}
+
+/********************************************
+** Function: createSegment(int capacity)
+** Pre-conditions: capacity is 1 or larger
+** Post-conditions: Returns an unlinked empty buffer whose header and storage both come
+** from m_resource. With size classes on, the capacity is rounded up to a class first.
+********************************************/
+Buffer* BufferList::createSegment(int capacity) {
+    if (m_sizeClasses) {
+        capacity = SizeClassTable::instance().roundUp(capacity);
+    }
+    void* memory = m_resource->allocate(sizeof(Buffer), alignof(Buffer));
+    return new (memory) Buffer(capacity, m_resource);
+}
+
+/********************************************
+** Function: copySegment(const Buffer& rhs)
+** Pre-conditions: None
+** Post-conditions: Returns an unlinked deep copy of rhs allocated from m_resource
+********************************************/
+Buffer* BufferList::copySegment(const Buffer& rhs) {
+    void* memory = m_resource->allocate(sizeof(Buffer), alignof(Buffer));
+    return new (memory) Buffer(rhs, m_resource);
+}
+
+/********************************************
+** Function: destroySegment(Buffer* segment)
+** Pre-conditions: segment was made by createSegment or copySegment, or is the inline
+** buffer, and is unlinked
+** Post-conditions: The buffer's storage and header are returned to m_resource. The
+** inline buffer is only emptied and marked as not in the list.
+********************************************/
+void BufferList::destroySegment(Buffer* segment) {
+    if (segment == &m_inline) {
+        m_inline.clear();
+        m_inline.m_next = nullptr;
+        m_inline.m_prev = nullptr;
+        return;
+    }
+    segment->~Buffer();
+    m_resource->deallocate(segment, sizeof(Buffer), alignof(Buffer));
+}
+
+/********************************************
+** Function: setPrefetch(bool enabled)
+** Pre-conditions: None
+** Post-conditions: dequeue prefetches the next buffer only when enabled
+********************************************/
+void BufferList::setPrefetch(bool enabled) {
+    m_prefetch = enabled;
+}
+
+/********************************************
+** Function: prefetchSegment(Buffer* segment)
+** Pre-conditions: segment is in the list
+** Post-conditions: A prefetch is issued for segment's header and its first two cache
+** lines of items. This is only a hint, nothing is read or written. A compressed segment
+** is skipped, its m_buffer holds the encoding and m_start does not index into it.
+********************************************/
+void BufferList::prefetchSegment(Buffer* segment) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (segment->m_compressed) return;
+    __builtin_prefetch(segment, 0, 3);
+    const int* first = segment->m_buffer + segment->m_start;
+    __builtin_prefetch(first, 0, 3);
+    __builtin_prefetch(first + PREFETCH_LEAD, 0, 3);
+#else
+    (void)segment;
+#endif
+}
+
+/********************************************
+** Function: useSizeClasses(bool enabled)
+** Pre-conditions: None
+** Post-conditions: Buffers created from now on have their capacity rounded up to the
+** next SizeClassTable class, so growth steps through the classes. An empty list
+** replaces its only buffer right away, unless that is the inline buffer.
+********************************************/
+void BufferList::useSizeClasses(bool enabled) {
+    m_sizeClasses = enabled;
+
+    if (m_cursor != nullptr && m_cursor != &m_inline && m_listSize == 1 && m_cursor->empty()
+        && m_reserved == nullptr && !m_bounded) {
+        Buffer* replacement = createSegment(m_minBufCapacity);
+        destroySegment(m_cursor);
+        m_cursor = replacement;
+        m_cursor->m_next = m_cursor;
+        m_cursor->m_prev = m_cursor;
+    }
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items in the list, walks every buffer
+********************************************/
+int BufferList::count() {
+    if (m_cursor == nullptr) return 0;
+
+    int total = 0;
     Buffer* temp = m_cursor->m_next;
     for (int i = 0; i < m_listSize; i++) {
-        temp->dump();
+        total += temp->count();
         temp = temp->m_next;
     }
-}
\ No newline at end of file
+    return total;
+}
+
+/********************************************
+** Function: bytesAllocated()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes requested from m_resource for every buffer header
+** and its storage, or its encoding if it is compressed. The inline buffer requested
+** nothing and counts 0.
+********************************************/
+long long BufferList::bytesAllocated() {
+    if (m_cursor == nullptr) return 0;
+
+    long long total = 0;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        if (temp == &m_inline) {
+            // lives inside the BufferList object
+        }
+        else if (temp->compressed()) {
+            total += sizeof(Buffer) + temp->packedBytes();
+        }
+        else {
+            total += sizeof(Buffer) + (long long)sizeof(int) * temp->capacity();
+        }
+        temp = temp->m_next;
+    }
+    return total;
+}
+
+/********************************************
+** Function: overheadPerElement()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes requested per item beyond sizeof(int), which
+** counts headers and unused capacity. An empty list returns all its bytes.
+********************************************/
+double BufferList::overheadPerElement() {
+    int items = count();
+    long long bytes = bytesAllocated();
+    if (items == 0) return (double)bytes;
+    return (double)(bytes - (long long)sizeof(int) * items) / items;
+}
+
+/********************************************
+** Function: setOverwriteCapacity(int capacity)
+** Pre-conditions: None
+** Post-conditions: For capacity 1 or larger, the list becomes one buffer of exactly
+** capacity items in overwrite mode. The newest items already queued are moved into it.
+** From then on enqueue never allocates and overwrites the oldest item when full.
+** A capacity of 0 or less turns overwriting off and lets the list grow again.
+********************************************/
+void BufferList::setOverwriteCapacity(int capacity) {
+    if (capacity < 1) {
+        m_bounded = false;
+        if (m_cursor != nullptr) {
+            m_cursor->setOverwrite(false);
+        }
+        return;
+    }
+
+    dropReservation();
+
+    // the ring has exactly the requested capacity, size classes are not applied
+    void* memory = m_resource->allocate(sizeof(Buffer), alignof(Buffer));
+    Buffer* ring = new (memory) Buffer(capacity, m_resource);
+    ring->setOverwrite(true);
+
+    // move the items over oldest first, the ring keeps the newest capacity of them
+    while (!empty()) {
+        ring->enqueue(dequeue());
+    }
+    if (m_cursor != nullptr) {
+        destroySegment(m_cursor);
+    }
+
+    m_cursor = ring;
+    m_cursor->m_next = m_cursor;
+    m_cursor->m_prev = m_cursor;
+    m_listSize = 1;
+    m_bounded = true;
+    retrack();
+}
+
+/********************************************
+** Function: dropped()
+** Pre-conditions: None
+** Post-conditions: Returns how many items the buffers still in the list have overwritten
+********************************************/
+unsigned long long BufferList::dropped() {
+    if (m_cursor == nullptr) return 0;
+
+    unsigned long long total = 0;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        total += temp->dropped();
+        temp = temp->m_next;
+    }
+    return total;
+}
+
+/********************************************
+** Function: setCompression(bool enabled)
+** Pre-conditions: None
+** Post-conditions: When enabled, each buffer that fills up is encoded once it is neither
+** the front nor the cursor, and decoded again when it becomes the front. Turning it
+** off decodes every buffer.
+********************************************/
+void BufferList::setCompression(bool enabled) {
+    m_compress = enabled;
+    if (!enabled) {
+        decompressAll();
+    }
+}
+
+/********************************************
+** Function: compressIfCold(Buffer* segment)
+** Pre-conditions: segment is in the list
+** Post-conditions: segment is encoded if it is full and is neither the front nor the cursor
+********************************************/
+void BufferList::compressIfCold(Buffer* segment) {
+    if (segment != m_cursor && segment != m_cursor->m_next && segment->full()) {
+        segment->compress();
+    }
+}
+
+/********************************************
+** Function: decompressAll()
+** Pre-conditions: None
+** Post-conditions: Every buffer in the list holds its items decoded
+********************************************/
+void BufferList::decompressAll() {
+    if (m_cursor == nullptr) return;
+
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        temp->decompress();
+        temp = temp->m_next;
+    }
+}
+
+/********************************************
+** Function: compressionRatio()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes the compressed buffers' items would take decoded
+** divided by the bytes of their encodings, 1 if nothing is compressed
+********************************************/
+double BufferList::compressionRatio() {
+    if (m_cursor == nullptr) return 1.0;
+
+    long long raw = 0;
+    long long packed = 0;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        if (temp->compressed()) {
+            raw += (long long)sizeof(int) * temp->count();
+            packed += temp->packedBytes();
+        }
+        temp = temp->m_next;
+    }
+    return (packed == 0) ? 1.0 : (double)raw / packed;
+}
+
+/********************************************
+** Function: dropReservation()
+** Pre-conditions: None
+** Post-conditions: An outstanding reservation is cancelled and its buffer freed
+********************************************/
+void BufferList::dropReservation() {
+    if (m_reserved != nullptr) {
+        destroySegment(m_reserved);
+        m_reserved = nullptr;
+    }
+    m_reservedCount = 0;
+    m_reservedInCursor = 0;
+}
+
+/********************************************
+** Function: appendSegment(Buffer* segment)
+** Pre-conditions: segment is not in any list, was allocated from a resource equal to
+** m_resource and holds at least one item
+** Post-conditions: segment becomes the cursor. An empty list gives up its only buffer
+** instead of keeping an empty buffer in front of segment.
+********************************************/
+void BufferList::appendSegment(Buffer* segment) {
+    if (m_cursor == nullptr || empty()) {
+        if (m_cursor != nullptr) {
+            destroySegment(m_cursor);
+        }
+        m_cursor = segment;
+        m_cursor->m_next = m_cursor;
+        m_cursor->m_prev = m_cursor;
+        m_listSize = 1;
+        return;
+    }
+
+    Buffer* previous = m_cursor;
+    linkAfter(m_cursor, segment);
+    m_cursor = segment;
+    if (m_compress) {
+        compressIfCold(previous);
+    }
+}
+
+/********************************************
+** Function: canShareSegments(const BufferList& other)
+** Pre-conditions: None
+** Post-conditions: Returns true if buffers can move between the lists as they are:
+** both allocate from equal resources and neither is a bounded overwrite ring
+********************************************/
+bool BufferList::canShareSegments(const BufferList& other) {
+    return m_resource->is_equal(*other.m_resource) && !m_bounded && !other.m_bounded;
+}
+
+/********************************************
+** Function: splice(BufferList& other)
+** Pre-conditions: None
+** Post-conditions: Every item of other is appended to this list in order and other is
+** left empty. When the buffers can be shared this only relinks pointers, O(1);
+** otherwise the items are moved one by one.
+********************************************/
+void BufferList::splice(BufferList& other) {
+    if (this == &other || other.empty()) return;
+
+    if (!canShareSegments(other)) {
+        while (!other.empty()) {
+            enqueue(other.dequeue());
+        }
+        return;
+    }
+
+    dropReservation();
+    other.dropReservation();
+    other.evictInline();
+
+    // other's buffers move as they are, the trackers are told item by item
+    if (m_tracker != nullptr) {
+        Buffer* temp = other.m_cursor->m_next;
+        for (int i = 0; i < other.m_listSize; i++) {
+            trackItems(temp, 0, temp->count(), nullptr, m_tracker);
+            temp = temp->m_next;
+        }
+    }
+    if (other.m_tracker != nullptr) {
+        other.m_tracker->reset();
+    }
+
+    Buffer* otherFront = other.m_cursor->m_next;
+    Buffer* otherCursor = other.m_cursor;
+    int otherSize = other.m_listSize;
+
+    // other starts over with its inline buffer before its ring is taken
+    other.resetToInline();
+
+    if (m_cursor == nullptr || empty()) {
+        if (m_cursor != nullptr) {
+            destroySegment(m_cursor);
+        }
+        m_cursor = otherCursor;
+        m_listSize = otherSize;
+        return;
+    }
+
+    // cursor -> other's front ... other's cursor -> our front
+    Buffer* previous = m_cursor;
+    Buffer* front = m_cursor->m_next;
+    previous->m_next = otherFront;
+    otherFront->m_prev = previous;
+    otherCursor->m_next = front;
+    front->m_prev = otherCursor;
+    m_cursor = otherCursor;
+    m_listSize += otherSize;
+
+    if (m_compress) {
+        compressIfCold(previous);
+    }
+}
+
+/********************************************
+** Function: transferFront(BufferList& other, int n)
+** Pre-conditions: n is 0 or larger
+** Post-conditions: The n oldest items of this list (or all of them, if fewer) are
+** appended to other in order. Whole front buffers are relinked into other, and at
+** most one boundary buffer is split by moving items one by one. Returns how many
+** items moved.
+********************************************/
+int BufferList::transferFront(BufferList& other, int n) {
+    if (this == &other || n <= 0) return 0;
+
+    int moved = 0;
+    if (canShareSegments(other)) {
+        other.dropReservation();
+        evictInline();
+        while (moved < n && !empty() && m_cursor->m_next->count() <= n - moved) {
+            Buffer* front = m_cursor->m_next;
+            moved += front->count();
+            if (m_tracker != nullptr || other.m_tracker != nullptr) {
+                trackItems(front, 0, front->count(), m_tracker, other.m_tracker);
+            }
+
+            if (m_listSize == 1) {
+                // the last buffer moves, this list starts over with its inline buffer
+                dropReservation();
+                resetToInline();
+            }
+            else {
+                detachSegment(front);
+            }
+            other.appendSegment(front);
+        }
+    }
+
+    // split the boundary buffer
+    while (moved < n && !empty()) {
+        other.enqueue(dequeue());
+        moved++;
+    }
+    return moved;
+}
+
+/********************************************
+** Function: collectChunks(int chunkSize)
+** Pre-conditions: chunkSize is 1 or larger
+** Post-conditions: Compressed buffers are decoded. Returns the items as contiguous
+** ranges, oldest first. A buffer gives one range, or two if it wraps around, and
+** ranges longer than chunkSize are cut into pieces of chunkSize.
+********************************************/
+std::vector<BufferWriteSpan> BufferList::collectChunks(int chunkSize) {
+    std::vector<BufferWriteSpan> chunks;
+    if (m_cursor == nullptr) return chunks;
+
+    decompressAll();
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        int first = temp->m_capacity - temp->m_start;
+        if (first > temp->m_count) first = temp->m_count;
+        BufferWriteSpan ranges[2] = {{temp->m_buffer + temp->m_start, first},
+                                     {temp->m_buffer, temp->m_count - first}};
+        for (BufferWriteSpan range : ranges) {
+            for (int offset = 0; offset < range.length; offset += chunkSize) {
+                int length = range.length - offset;
+                if (length > chunkSize) length = chunkSize;
+                chunks.push_back({range.data + offset, length});
+            }
+        }
+        temp = temp->m_next;
+    }
+    return chunks;
+}
+
+/********************************************
+** Function: growthCapacity(Buffer* segment)
+** Pre-conditions: segment is in the list
+** Post-conditions: Returns the capacity of a buffer added next to segment. An inline
+** buffer smaller than m_minBufCapacity is followed by one of m_minBufCapacity, any other
+** buffer by nextCapacity, so small lists grow just like they did without it.
+********************************************/
+int BufferList::growthCapacity(Buffer* segment) {
+    if (segment == &m_inline && m_inline.m_capacity < m_minBufCapacity) {
+        return m_minBufCapacity;
+    }
+    return nextCapacity(segment->capacity());
+}
+
+/********************************************
+** Function: resetToInline()
+** Pre-conditions: Every other buffer has been deleted or handed to another list
+** Post-conditions: The empty inline buffer is the only buffer and the cursor. It holds
+** m_minBufCapacity items, or INLINE_CAPACITY if that is less.
+********************************************/
+void BufferList::resetToInline() {
+    m_inline.clear();
+    m_inline.m_capacity = (m_minBufCapacity < INLINE_CAPACITY) ? m_minBufCapacity : INLINE_CAPACITY;
+    m_inline.m_next = &m_inline;
+    m_inline.m_prev = &m_inline;
+    m_cursor = &m_inline;
+    m_listSize = 1;
+}
+
+/********************************************
+** Function: copyInline(const Buffer& rhs)
+** Pre-conditions: rhs is the inline buffer of another list, m_inline is empty
+** Post-conditions: rhs's capacity, items and positions are copied into m_inline, which
+** is returned unlinked
+********************************************/
+Buffer* BufferList::copyInline(const Buffer& rhs) {
+    for (int i = 0; i < rhs.m_capacity; i++) {
+        m_inlineStorage[i] = rhs.m_buffer[i];
+    }
+    m_inline.m_capacity = rhs.m_capacity;
+    m_inline.m_count = rhs.m_count;
+    m_inline.m_start = rhs.m_start;
+    m_inline.m_end = rhs.m_end;
+    return &m_inline;
+}
+
+/********************************************
+** Function: evictInline()
+** Pre-conditions: None
+** Post-conditions: If the inline buffer holds items it is replaced, in place, by a
+** heap copy allocated from m_resource, so every buffer of the list can be relinked into
+** another list. The inline buffer is left empty and out of the list, unless the list
+** is empty and it is the only buffer. A reserve into the inline cursor is cancelled.
+********************************************/
+void BufferList::evictInline() {
+    if (m_inline.m_next == nullptr) return;
+    if (m_inline.empty()) {
+        // an empty inline buffer has nothing worth moving
+        if (m_listSize > 1) {
+            unlinkSegment(&m_inline);
+        }
+        return;
+    }
+
+    if (m_cursor == &m_inline) {
+        // reserved slots point into the inline storage
+        dropReservation();
+    }
+
+    Buffer* copy = copySegment(m_inline);
+    if (m_listSize == 1) {
+        copy->m_next = copy;
+        copy->m_prev = copy;
+    }
+    else {
+        copy->m_next = m_inline.m_next;
+        copy->m_prev = m_inline.m_prev;
+        m_inline.m_prev->m_next = copy;
+        m_inline.m_next->m_prev = copy;
+    }
+    if (m_cursor == &m_inline) {
+        m_cursor = copy;
+    }
+    destroySegment(&m_inline);
+}
+/********************************************
+** Function: setTracker(AggregateTracker* tracker)
+** Pre-conditions: tracker outlives the list or is detached first
+** Post-conditions: tracker is reset and told about every item, oldest first, O(n).
+** From then on it is told about every item added at the back and removed at the front;
+** pushFront, popBack, removeIf and parallelForEach rebuild it, O(n). nullptr detaches it.
+********************************************/
+void BufferList::setTracker(AggregateTracker* tracker) {
+    m_tracker = tracker;
+    retrack();
+}
+
+/********************************************
+** Function: trackItems(Buffer* segment, int skip, int k, AggregateTracker* popFrom, AggregateTracker* pushTo)
+** Pre-conditions: segment holds at least skip + k items
+** Post-conditions: segment is decoded, then for its k items after the skip oldest, oldest
+** first, popFrom is told each was popped and pushTo that it was pushed. Either may be nullptr.
+********************************************/
+void BufferList::trackItems(Buffer* segment, int skip, int k, AggregateTracker* popFrom, AggregateTracker* pushTo) {
+    if (k <= 0) return;
+
+    segment->decompress();
+    int index = (segment->m_start + skip) % segment->m_capacity;
+    for (int i = 0; i < k; i++) {
+        int value = segment->m_buffer[index];
+        if (popFrom != nullptr) popFrom->popped(value);
+        if (pushTo != nullptr) pushTo->pushed(value);
+        index = (index + 1 == segment->m_capacity) ? 0 : index + 1;
+    }
+}
+
+/********************************************
+** Function: retrack()
+** Pre-conditions: None
+** Post-conditions: If there is a tracker, it is reset and told about every item again,
+** oldest first
+********************************************/
+void BufferList::retrack() {
+    if (m_tracker == nullptr) return;
+
+    m_tracker->reset();
+    if (m_cursor == nullptr) return;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        trackItems(temp, 0, temp->count(), nullptr, m_tracker);
+        temp = temp->m_next;
+    }
+}
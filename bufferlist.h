@@ -7,7 +7,8 @@
 ** E-mail: DanielWu1510@tamu.edu
 **
 ** This file contains the declaration for the BufferList class.
-** This class is a circular linked list of Buffer objects.
+** This class is a circular doubly linked list of Buffer objects.
+** Items can also be added at the front and removed from the back, so it works as a deque.
 ******************************************************************************************/
 
 
@@ -15,6 +16,9 @@
 #ifndef BUFFERLIST_H
 #define BUFFERLIST_H
 #include "buffer.h"
+#include "workerpool.h"
+#include "aggregatetracker.h"
+#include <vector>
 class Grader;//this class is for grading purposes, no need to do anything
 //the following is your tester class, you add your test functions in this class
 //you declare and implement the Tester class in your mytest.cpp file
@@ -22,27 +26,188 @@ class Tester;
 const int DEFAULT_MIN_CAPACITY = 10;
 const int MAX_FACTOR = 16;
 const int INCREASE_FACTOR = 2;
+const int INLINE_CAPACITY = CACHE_LINE_SIZE / sizeof(int);  // most items held inside the BufferList object itself
+const int PARALLEL_CHUNK = 16384;   // most items one parallel task works on
+const int PREFETCH_LEAD = CACHE_LINE_SIZE / sizeof(int); // items left in the front buffer when the next one is prefetched
 class BufferList{
     public:
     friend class Grader;//Grader will have access to private members of BufferList
     friend class Tester;//Tester will have access to private members of BufferList
-    BufferList(int minBufCapacity);     //constructor
+    BufferList(int minBufCapacity, std::pmr::memory_resource * resource = std::pmr::get_default_resource()); //constructor
     ~BufferList();                      //destructor
-    BufferList(const BufferList & rhs); //copy constructor
+    BufferList(const BufferList & rhs); //copy constructor, the copy uses the default memory resource
     const BufferList & operator=(const BufferList & rhs);// overloaded assignment operator
     void enqueue(const int & data);	    //add data
     int dequeue();			            //remove data
+    void pushFront(const int & data);   //add data at the front, it is dequeued next
+    int popBack();                      //remove the newest data
+    int front();                        //returns the oldest data without removing it
+    int back();                         //returns the newest data without removing it
+    BufferView peekBatch(int n, int skip = 0);  //view of up to n items after the skip oldest, no copying
+    int consume(int k);                 //removes up to k oldest items, returns how many
+    BufferReservation reserve(int n);   //writable slots for up to n new items at the end
+    void commit(int k);                 //publishes the first k reserved slots
     void clear();           //clear all data, deallocate all memory
-    void dump();            //prints out the contents, for debugging purposes
+    bool empty();           //returns true if there is nothing to dequeue
+    void dump();            //prints out the contents, for debugging purposes, a plain export to cout
+    void exportTo(ExportWriter & out, ExportFormat format); //writes every buffer, front first, as text
+    void setPrefetch(bool enabled); //prefetch the next buffer when the front one nearly drains, on by default
+    void useSizeClasses(bool enabled);  //round new buffer capacities up to cache and page friendly sizes
+    int count();                    //returns the number of items in the list
+    long long bytesAllocated();     //bytes requested for buffer headers and storage
+    double overheadPerElement();    //bytes requested per item beyond the item itself
+    void setOverwriteCapacity(int capacity); //keep only the newest capacity items in one fixed buffer, 0 turns it off
+    unsigned long long dropped();   //number of items overwritten by the fixed buffer
+    void setCompression(bool enabled);  //encode full buffers between the front and the cursor
+    double compressionRatio();      //raw bytes over encoded bytes of the compressed buffers
+    void splice(BufferList & other);    //appends all of other's items, O(1) when buffers can be shared
+    int transferFront(BufferList & other, int n);   //moves the n oldest items to the back of other
+    void setTracker(AggregateTracker * tracker);    //tells tracker about every item added and removed, nullptr detaches
+    template <typename Pred>
+    int removeIf(Pred pred);    //removes every item matching pred, returns how many were removed
+    template <typename Fn>
+    void parallelForEach(WorkerPool & pool, Fn fn);    //calls fn(int&) on every item, chunks run in parallel
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(WorkerPool & pool, T init, Map map, Combine combine); //maps chunks in parallel, combines in FIFO order
+    template <typename Fn>
+    int parallelDrain(WorkerPool & pool, Fn fn);       //hands every chunk to fn in parallel, then empties the list
 
 
     private:
     Buffer * m_cursor;      //the cursor is the rear of list and its next points to front of list
     int m_listSize;         //this is the size of linked list, i.e. number of nodes in the list
     int m_minBufCapacity;   //the min size for circular buffers in the list
+    Buffer * m_reserved;    //buffer allocated by reserve, linked in by commit
+    int m_reservedCount;    //number of slots handed out by the last reserve
+    int m_reservedInCursor; //how many of them are in the cursor, the rest are in m_reserved
+    std::pmr::memory_resource * m_resource; //where buffers and their storage are allocated from
+    bool m_prefetch;        //whether dequeue prefetches the next buffer
+    bool m_sizeClasses;     //whether new buffer capacities are rounded to a SizeClassTable class
+    bool m_bounded;         //whether the list is one fixed buffer that overwrites its oldest item
+    bool m_compress;        //whether full buffers between the front and the cursor are encoded
+    AggregateTracker * m_tracker;   //told about every item added and removed, nullptr if none, not owned
+    Buffer m_inline;        //first buffer of every list, min(m_minBufCapacity, INLINE_CAPACITY) items in m_inlineStorage, never on the heap
+    alignas(CACHE_LINE_SIZE) int m_inlineStorage[INLINE_CAPACITY]; //items of m_inline
 
     // ***************************************************
     // Any private helper functions must be delared here!
     // ***************************************************
+    void pruneEmptySegments();  //unlinks and deletes empty buffers, always keeps at least one
+    int nextCapacity(int capacity);             //capacity of a buffer grown after one of the given capacity
+    void linkAfter(Buffer* position, Buffer* segment);  //links segment in after position
+    void unlinkSegment(Buffer* segment);        //unlinks and deletes segment, moves the cursor back if needed
+    void detachSegment(Buffer* segment);        //unlinks segment without deleting it
+    void appendSegment(Buffer* segment);        //links an unlinked, non-empty segment in as the cursor
+    bool canShareSegments(const BufferList & other); //whether buffers can move between the lists as they are
+    void dropReservation();                     //cancels an outstanding reserve
+    Buffer* createSegment(int capacity);        //allocates a buffer and its storage from m_resource
+    Buffer* copySegment(const Buffer & rhs);    //allocates a deep copy of rhs from m_resource
+    void destroySegment(Buffer* segment);       //returns a buffer and its storage to m_resource
+    void copyList(const BufferList & rhs);      //deep copies rhs's buffers into this empty list
+    void prefetchSegment(Buffer* segment);      //pulls segment's header and first items into cache
+    void compressIfCold(Buffer* segment);       //encodes segment if it is full and neither front nor cursor
+    void decompressAll();                       //decodes every compressed buffer
+    std::vector<BufferWriteSpan> collectChunks(int chunkSize);  //contiguous item ranges of at most chunkSize, oldest first
+    int growthCapacity(Buffer* segment);        //capacity of a buffer added next to segment
+    void resetToInline();                       //makes the empty inline buffer the only buffer
+    Buffer* copyInline(const Buffer & rhs);     //copies another list's inline buffer into m_inline
+    void evictInline();                         //moves the inline buffer's items to the heap before buffers leave the list
+    void trackItems(Buffer* segment, int skip, int k, AggregateTracker* popFrom, AggregateTracker* pushTo); //reports k of segment's items
+    void retrack();                             //resets m_tracker and reports every item again, oldest first
 };
+
+/********************************************
+** Function: removeIf(Pred pred)
+** Pre-conditions: pred is callable as bool pred(int)
+** Post-conditions: Every buffer is compacted in place, buffers left empty are deleted
+** and the circular links are repaired. An outstanding reserve is cancelled. A tracker
+** is rebuilt, O(n), if anything was removed. Returns the number of items removed.
+********************************************/
+template <typename Pred>
+int BufferList::removeIf(Pred pred) {
+    if (m_cursor == nullptr) return 0;
+
+    // compaction moves the cursor's end, so reserved slots would no longer follow it
+    dropReservation();
+
+    // buffers spliced in from a compressing list may be encoded even if this one is not
+    decompressAll();
+
+    int removed = 0;
+    Buffer* temp = m_cursor->m_next;
+    for (int i = 0; i < m_listSize; i++) {
+        removed += temp->removeIf(pred);
+        temp = temp->m_next;
+    }
+
+    if (removed > 0) {
+        pruneEmptySegments();
+        retrack();
+    }
+    return removed;
+}
+
+/********************************************
+** Function: parallelForEach(WorkerPool& pool, Fn fn)
+** Pre-conditions: fn is callable as void fn(int&) and is safe to call from several
+** threads at once. No other thread uses the list during the call.
+** Post-conditions: fn was called on every item in place. Buffers, and pieces of at
+** most PARALLEL_CHUNK items of large buffers, are handed to the pool's threads.
+** A tracker is rebuilt afterwards, since fn may change any item.
+********************************************/
+template <typename Fn>
+void BufferList::parallelForEach(WorkerPool & pool, Fn fn) {
+    std::vector<BufferWriteSpan> chunks = collectChunks(PARALLEL_CHUNK);
+    pool.run((int)chunks.size(), [&chunks, &fn](int index) {
+        BufferWriteSpan chunk = chunks[index];
+        for (int i = 0; i < chunk.length; i++) {
+            fn(chunk.data[i]);
+        }
+    });
+    retrack();
+}
+
+/********************************************
+** Function: parallelReduce(WorkerPool& pool, T init, Map map, Combine combine)
+** Pre-conditions: map is callable as T map(const int* data, int length) and is safe to
+** call from several threads at once, combine is callable as T combine(T, T)
+** Post-conditions: Every chunk is mapped in parallel, then the per chunk results are
+** folded into init oldest chunk first on the calling thread, so combine need not be
+** commutative. The list is unchanged.
+********************************************/
+template <typename T, typename Map, typename Combine>
+T BufferList::parallelReduce(WorkerPool & pool, T init, Map map, Combine combine) {
+    std::vector<BufferWriteSpan> chunks = collectChunks(PARALLEL_CHUNK);
+    // one cache line per result, so no two threads write the same word, even for
+    // T = bool where std::vector<bool> would pack the results into shared words
+    struct alignas(CACHE_LINE_SIZE) ChunkResult{
+        T value;
+    };
+    std::vector<ChunkResult> results(chunks.size(), ChunkResult{init});
+    pool.run((int)chunks.size(), [&chunks, &results, &map](int index) {
+        results[index].value = map((const int*)chunks[index].data, chunks[index].length);
+    });
+
+    T result = init;
+    for (size_t i = 0; i < results.size(); i++) {
+        result = combine(result, results[i].value);
+    }
+    return result;
+}
+
+/********************************************
+** Function: parallelDrain(WorkerPool& pool, Fn fn)
+** Pre-conditions: fn is callable as void fn(const int* data, int length) and is safe
+** to call from several threads at once
+** Post-conditions: fn was called once for every chunk, then every item is removed and
+** the list keeps one empty buffer. Returns the number of items drained.
+********************************************/
+template <typename Fn>
+int BufferList::parallelDrain(WorkerPool & pool, Fn fn) {
+    std::vector<BufferWriteSpan> chunks = collectChunks(PARALLEL_CHUNK);
+    pool.run((int)chunks.size(), [&chunks, &fn](int index) {
+        fn((const int*)chunks[index].data, chunks[index].length);
+    });
+    return consume(count());
+}
 #endif
\ No newline at end of file
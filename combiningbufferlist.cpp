@@ -0,0 +1,258 @@
+/******************************************************************************************
+** File: combiningbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the CombiningBufferList class.
+** Slot ids belong to threads, not to lists: a thread takes the lowest free id the first
+** time it uses any CombiningBufferList and gives it back when it exits, so the slots a
+** combiner scans stay packed at the start of the array.
+******************************************************************************************/
+
+#include "combiningbufferlist.h"
+#include <vector>
+#include <thread>
+
+static std::mutex slotIdMutex;          // guards freeSlotIds and nextSlotId
+static std::vector<int> freeSlotIds;    // ids given back by threads that exited
+static int nextSlotId = 0;              // lowest id never handed out
+
+// a thread's slot id, taken on first use and given back when the thread exits
+struct ThreadSlotId{
+    int id;
+    ThreadSlotId() {
+        std::lock_guard<std::mutex> lock(slotIdMutex);
+        if (!freeSlotIds.empty()) {
+            id = freeSlotIds.back();
+            freeSlotIds.pop_back();
+        }
+        else {
+            id = nextSlotId++;
+        }
+    }
+    ~ThreadSlotId() {
+        std::lock_guard<std::mutex> lock(slotIdMutex);
+        freeSlotIds.push_back(id);
+    }
+};
+static thread_local ThreadSlotId threadSlotId;
+
+/********************************************
+** Function: CombiningBufferList(int minBufCapacity)
+** Pre-conditions: minBufCapacity is an integer larger than 0
+** Post-conditions: An empty list with MAX_COMBINING_SLOTS idle slots is created
+********************************************/
+CombiningBufferList::CombiningBufferList(int minBufCapacity) {
+    m_list = new BufferList(minBufCapacity);
+    m_slots = new Slot[MAX_COMBINING_SLOTS];
+    for (int i = 0; i < MAX_COMBINING_SLOTS; i++) {
+        m_slots[i].state = SLOT_IDLE;
+        m_slots[i].value = 0;
+    }
+    m_slotsInUse = 0;
+    m_passes = 0;
+    m_combined = 0;
+}
+
+/********************************************
+** Function: ~CombiningBufferList()
+** Pre-conditions: No other thread uses the object
+** Post-conditions: The list and the slots are deallocated
+********************************************/
+CombiningBufferList::~CombiningBufferList() {
+    delete m_list;
+    delete[] m_slots;
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: data is added to the back of the list by a combining pass, which
+** may run on this thread or on another
+********************************************/
+void CombiningBufferList::enqueue(const int& data) {
+    int value = data;
+    publish(SLOT_ENQUEUE, value);
+}
+
+/********************************************
+** Function: tryDequeue(int& data)
+** Pre-conditions: None
+** Post-conditions: If the list holds an item when a pass applies the request, the
+** oldest item is removed into data and true is returned, otherwise false
+********************************************/
+bool CombiningBufferList::tryDequeue(int& data) {
+    int value = 0;
+    if (publish(SLOT_DEQUEUE, value) == SLOT_DONE_EMPTY) {
+        return false;
+    }
+    data = value;
+    return true;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items, which may already be stale if other
+** threads are using the list
+********************************************/
+int CombiningBufferList::count() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_list->count();
+}
+
+/********************************************
+** Function: clear()
+** Pre-conditions: None
+** Post-conditions: Every item is removed and the list's memory is freed
+********************************************/
+void CombiningBufferList::clear() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_list->clear();
+}
+
+/********************************************
+** Function: passes()
+** Pre-conditions: None
+** Post-conditions: Returns the number of combining passes that applied at least one request
+********************************************/
+unsigned long long CombiningBufferList::passes() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_passes;
+}
+
+/********************************************
+** Function: combined()
+** Pre-conditions: None
+** Post-conditions: Returns the number of requests applied by combining passes, so
+** combined() / passes() is the average batch
+********************************************/
+unsigned long long CombiningBufferList::combined() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_combined;
+}
+
+/********************************************
+** Function: publish(int state, int& value)
+** Pre-conditions: state is SLOT_ENQUEUE or SLOT_DEQUEUE
+** Post-conditions: The request is stored in the calling thread's slot, then the thread
+** waits until a pass has applied it, running the pass itself whenever it gets the lock.
+** Returns SLOT_DONE or SLOT_DONE_EMPTY, and a dequeued item in value. A thread without
+** a slot takes the lock and applies its request directly.
+********************************************/
+int CombiningBufferList::publish(int state, int& value) {
+    int id = threadSlotId.id;
+    if (id >= MAX_COMBINING_SLOTS) {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (state == SLOT_ENQUEUE) {
+            m_list->enqueue(value);
+            return SLOT_DONE;
+        }
+        if (m_list->empty()) return SLOT_DONE_EMPTY;
+        value = m_list->dequeue();
+        return SLOT_DONE;
+    }
+
+    // make sure the combiner scans this far
+    int inUse = m_slotsInUse.load(std::memory_order_relaxed);
+    while (inUse <= id && !m_slotsInUse.compare_exchange_weak(inUse, id + 1, std::memory_order_release)) {
+    }
+
+    Slot & slot = m_slots[id];
+    slot.value = value;
+    slot.state.store(state, std::memory_order_release);
+
+    int spins = 0;
+    while (true) {
+        int current = slot.state.load(std::memory_order_acquire);
+        if (current == SLOT_DONE || current == SLOT_DONE_EMPTY) {
+            value = slot.value;
+            slot.state.store(SLOT_IDLE, std::memory_order_relaxed);
+            return current;
+        }
+        if (m_lock.try_lock()) {
+            // the request is published, so this pass applies it if no earlier one did
+            combine();
+            m_lock.unlock();
+            continue;
+        }
+        if (++spins > COMBINING_SPINS) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/********************************************
+** Function: combine()
+** Pre-conditions: m_lock is held by the calling thread
+** Post-conditions: Every published request is applied. The enqueues go in with one
+** reserve and commit, in slot order, then the dequeues take the oldest items in slot
+** order through peekBatch and consume; a lone request uses enqueue or dequeue. Slots
+** are marked done only after the list has been updated, so an owner never sees its
+** slot before its request took effect.
+********************************************/
+void CombiningBufferList::combine() {
+    int enqueues[MAX_COMBINING_SLOTS];
+    int dequeues[MAX_COMBINING_SLOTS];
+    int enqueueCount = 0;
+    int dequeueCount = 0;
+    int inUse = m_slotsInUse.load(std::memory_order_acquire);
+    for (int i = 0; i < inUse; i++) {
+        int state = m_slots[i].state.load(std::memory_order_acquire);
+        if (state == SLOT_ENQUEUE) {
+            enqueues[enqueueCount++] = i;
+        }
+        else if (state == SLOT_DEQUEUE) {
+            dequeues[dequeueCount++] = i;
+        }
+    }
+    if (enqueueCount + dequeueCount == 0) return;
+
+    if (enqueueCount == 1) {
+        // a reservation does not pay for itself on one item
+        m_list->enqueue(m_slots[enqueues[0]].value);
+        m_slots[enqueues[0]].state.store(SLOT_DONE, std::memory_order_release);
+    }
+    else if (enqueueCount > 1) {
+        BufferReservation reservation = m_list->reserve(enqueueCount);
+        int next = 0;
+        for (int s = 0; s < reservation.spanCount; s++) {
+            for (int i = 0; i < reservation.spans[s].length; i++) {
+                reservation.spans[s].data[i] = m_slots[enqueues[next++]].value;
+            }
+        }
+        m_list->commit(enqueueCount);
+        for (int i = 0; i < enqueueCount; i++) {
+            m_slots[enqueues[i]].state.store(SLOT_DONE, std::memory_order_release);
+        }
+    }
+
+    int served = 0;
+    if (dequeueCount == 1 && !m_list->empty()) {
+        m_slots[dequeues[0]].value = m_list->dequeue();
+        m_slots[dequeues[0]].state.store(SLOT_DONE, std::memory_order_release);
+        served = 1;
+    }
+    while (served < dequeueCount && !m_list->empty()) {
+        BufferView view = m_list->peekBatch(dequeueCount - served);
+        int taken = served;
+        for (int s = 0; s < view.spanCount; s++) {
+            for (int i = 0; i < view.spans[s].length; i++) {
+                m_slots[dequeues[taken++]].value = view.spans[s].data[i];
+            }
+        }
+        m_list->consume(view.total);
+        for (; served < taken; served++) {
+            m_slots[dequeues[served]].state.store(SLOT_DONE, std::memory_order_release);
+        }
+    }
+    for (; served < dequeueCount; served++) {
+        m_slots[dequeues[served]].state.store(SLOT_DONE_EMPTY, std::memory_order_release);
+    }
+
+    m_passes++;
+    m_combined += enqueueCount + dequeueCount;
+}
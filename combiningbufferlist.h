@@ -0,0 +1,73 @@
+/******************************************************************************************
+** File: combiningbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the CombiningBufferList class.
+** This class is a BufferList shared by many threads through flat combining. A thread
+** publishes its enqueue or dequeue in its own slot, and whichever thread gets the lock
+** applies every published request in one pass, enqueues through reserve and commit and
+** dequeues through peekBatch and consume. The list is only touched by the combiner, so
+** its buffers stay in one core's cache instead of moving with the lock.
+**
+** Requests applied in one pass are concurrent, so every order is a valid one; a pass
+** applies the enqueues in slot order first, then the dequeues. Items from one thread
+** come out in the order that thread enqueued them.
+******************************************************************************************/
+
+
+
+#ifndef COMBININGBUFFERLIST_H
+#define COMBININGBUFFERLIST_H
+#include "bufferlist.h"
+#include <mutex>
+#include <atomic>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const int MAX_COMBINING_SLOTS = 64;     // threads that publish requests, the rest take the lock themselves
+const int COMBINING_SPINS = 64;         // spins on a slot before yielding
+class CombiningBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of CombiningBufferList
+    friend class Tester;//Tester will have access to private members of CombiningBufferList
+    CombiningBufferList(int minBufCapacity);    //constructor
+    ~CombiningBufferList();                     //destructor
+    CombiningBufferList(const CombiningBufferList & rhs) = delete;  //the slots are tied to threads
+    CombiningBufferList & operator=(const CombiningBufferList & rhs) = delete;
+    void enqueue(const int & data);     //add data
+    bool tryDequeue(int & data);        //removes the oldest item into data, false if there is none
+    int count();                        //number of items, approximate while in use
+    void clear();                       //removes every item
+    unsigned long long passes();        //combining passes so far
+    unsigned long long combined();      //requests applied by combining passes so far
+
+
+    private:
+    enum SlotState{
+        SLOT_IDLE,          // no request
+        SLOT_ENQUEUE,       // value is to be enqueued
+        SLOT_DEQUEUE,       // an item is wanted in value
+        SLOT_DONE,          // applied, value holds a dequeued item
+        SLOT_DONE_EMPTY     // applied, there was nothing to dequeue
+    };
+    struct alignas(CACHE_LINE_SIZE) Slot{
+        std::atomic<int> state;     // a SlotState, the owner sets requests, the combiner sets results
+        int value;                  // the item to enqueue or the item dequeued
+    };
+    BufferList *m_list;         //the items, only used while holding m_lock
+    std::mutex m_lock;          //held by the combiner
+    Slot *m_slots;              //one per thread, by the thread's slot id
+    std::atomic<int> m_slotsInUse;  //one more than the highest slot id that published, the combiner scans that far
+    unsigned long long m_passes;    //combining passes, guarded by m_lock
+    unsigned long long m_combined;  //requests applied by passes, guarded by m_lock
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    int publish(int state, int & value);    //runs a request through the calling thread's slot, returns the final state
+    void combine();                         //applies every published request, m_lock is held
+};
+#endif
@@ -0,0 +1,484 @@
+/******************************************************************************************
+** File: durablebufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the DurableBufferList class.
+** The journal is a 4 byte magic followed by 5 byte records: a tag, then a 32 bit value
+** in host byte order. 'E' enqueues the value, 'D' dequeues that many items. Records are
+** appended in the order the operations happened, so any prefix of the file is a valid
+** history and a record cut off by a crash is simply dropped on recovery. A checkpoint
+** writes the live items to a new file, syncs it and renames it over the journal.
+** An enqueued item is only put in the list by the leader that synced its record, so a
+** failed sync never leaves behind an item that was not acknowledged. Items of one batch
+** go in in journal order, and they are newer than every item already in the list, so
+** a dequeue journaled between them still takes the item replay will take.
+******************************************************************************************/
+
+#include "durablebufferlist.h"
+#include <system_error>
+#include <stdexcept>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char JOURNAL_MAGIC[4] = {'B', 'L', 'J', '1'};     // first bytes of every journal
+static const int RECORD_BYTES = 5;      // tag plus a 32 bit value
+
+/********************************************
+** Function: DurableBufferList(const std::string& path, int minBufCapacity)
+** Pre-conditions: No other object uses the journal at path
+** Post-conditions: The journal at path is opened, or created and synced if it does not
+** exist, and every item it holds is replayed into the list. Throws std::system_error
+** if the file cannot be used and std::runtime_error if it is not a journal.
+********************************************/
+DurableBufferList::DurableBufferList(const std::string& path, int minBufCapacity)
+    : m_list(minBufCapacity), m_path(path) {
+    m_appended = 0;
+    m_durable = 0;
+    m_flushing = false;
+    m_commitDelay = std::chrono::microseconds(0);
+    m_commitBatch = 1;
+    m_checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL;
+    m_dequeuesSinceCheckpoint = 0;
+    m_syncs = 0;
+    m_journalBytes = 0;
+    m_recovered = 0;
+
+    m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + m_path);
+    }
+    try {
+        replay();
+    }
+    catch (...) {
+        close(m_fd);
+        throw;
+    }
+}
+
+/********************************************
+** Function: ~DurableBufferList()
+** Pre-conditions: No other thread uses the object
+** Post-conditions: Pending dequeue records are synced and the journal is closed
+********************************************/
+DurableBufferList::~DurableBufferList() {
+    try {
+        sync();
+    }
+    catch (...) {
+        // a destructor cannot report it, the records are redelivered on recovery
+    }
+    close(m_fd);
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: data's record is on disk and data is added to the list before the
+** call returns. Concurrent calls share fsyncs. Throws std::system_error if the journal
+** cannot be written, in that case data is not added and its record is withdrawn.
+********************************************/
+void DurableBufferList::enqueue(const int& data) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    appendRecord('E', data);
+    unsigned long long record = m_appended;
+    try {
+        waitDurable(lock, record);
+    }
+    catch (const std::system_error&) {
+        // the failed batch went back to m_pending for the next leader, take this record out
+        for (size_t i = 0; i < m_pending.size(); i++) {
+            if (m_pending[i].number == record) {
+                m_pending.erase(m_pending.begin() + i);
+                break;
+            }
+        }
+        throw;
+    }
+}
+
+/********************************************
+** Function: dequeue()
+** Pre-conditions: None
+** Post-conditions: The oldest item is removed and returned. Its record is written with
+** the next sync, and every setCheckpointInterval dequeues the journal is checkpointed.
+** The item is returned even if that checkpoint fails: the old journal and the pending
+** records are kept, and the checkpoint is tried again after another interval.
+** Throws std::underflow_error if the list is empty.
+********************************************/
+int DurableBufferList::dequeue() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_list.empty()) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+    int data = m_list.dequeue();
+    appendRecord('D', 1);
+    m_dequeuesSinceCheckpoint += 1;
+
+    if (m_checkpointInterval > 0 && m_dequeuesSinceCheckpoint >= m_checkpointInterval) {
+        m_flushed.wait(lock, [this] { return !m_flushing; });
+        try {
+            checkpointLocked();
+        }
+        catch (const std::system_error&) {
+            // the item is already out of the list, losing it would be worse than a long journal
+            m_dequeuesSinceCheckpoint = 0;
+        }
+    }
+    return data;
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if there is nothing to dequeue
+********************************************/
+bool DurableBufferList::empty() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_list.empty();
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items in the list
+********************************************/
+int DurableBufferList::count() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_list.count();
+}
+
+/********************************************
+** Function: setGroupCommit(std::chrono::microseconds delay, int batch)
+** Pre-conditions: None
+** Post-conditions: A leader waits up to delay for batch records to be pending before it
+** syncs. A delay of 0 syncs at once: the lowest latency, but only enqueuers that arrive
+** during a sync share the next one. Longer delays trade latency for fewer fsyncs.
+********************************************/
+void DurableBufferList::setGroupCommit(std::chrono::microseconds delay, int batch) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commitDelay = delay;
+    m_commitBatch = (batch < 1) ? 1 : batch;
+}
+
+/********************************************
+** Function: setCheckpointInterval(int dequeues)
+** Pre-conditions: None
+** Post-conditions: The journal is checkpointed every dequeues dequeues, or never for 0
+********************************************/
+void DurableBufferList::setCheckpointInterval(int dequeues) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_checkpointInterval = (dequeues < 0) ? 0 : dequeues;
+}
+
+/********************************************
+** Function: sync()
+** Pre-conditions: None
+** Post-conditions: Every record appended so far, dequeues included, is on disk
+********************************************/
+void DurableBufferList::sync() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitDurable(lock, m_appended);
+}
+
+/********************************************
+** Function: checkpoint()
+** Pre-conditions: None
+** Post-conditions: The journal holds just an 'E' record per live item and is durable
+********************************************/
+void DurableBufferList::checkpoint() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_flushed.wait(lock, [this] { return !m_flushing; });
+    checkpointLocked();
+}
+
+/********************************************
+** Function: syncs()
+** Pre-conditions: None
+** Post-conditions: Returns the number of fsyncs so far
+********************************************/
+unsigned long long DurableBufferList::syncs() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_syncs;
+}
+
+/********************************************
+** Function: journalBytes()
+** Pre-conditions: None
+** Post-conditions: Returns the size of the journal file, records not written yet excluded
+********************************************/
+long long DurableBufferList::journalBytes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_journalBytes;
+}
+
+/********************************************
+** Function: recovered()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items the journal held when it was opened
+********************************************/
+int DurableBufferList::recovered() {
+    return m_recovered;
+}
+
+/********************************************
+** Function: appendRecord(char tag, int value)
+** Pre-conditions: m_mutex is held
+** Post-conditions: The record is added to m_pending and counted in m_appended. A leader
+** waiting for its batch is woken when the batch is full.
+********************************************/
+void DurableBufferList::appendRecord(char tag, int value) {
+    m_appended += 1;
+    JournalRecord record;
+    record.tag = tag;
+    record.value = value;
+    record.number = m_appended;
+    m_pending.push_back(record);
+    if ((int)m_pending.size() >= m_commitBatch) {
+        m_gather.notify_one();
+    }
+}
+
+/********************************************
+** Function: waitDurable(std::unique_lock<std::mutex>& lock, unsigned long long record)
+** Pre-conditions: lock holds m_mutex
+** Post-conditions: Returns once the first record records are on disk. If no sync is
+** running the caller leads one: it waits up to the commit delay for a full batch, then
+** encodes, writes and syncs every pending record without the lock, puts the batch's
+** enqueued items in the list and wakes the others. If the sync fails the batch goes back
+** to the front of m_pending and the leader throws std::system_error, the others retry.
+********************************************/
+void DurableBufferList::waitDurable(std::unique_lock<std::mutex>& lock, unsigned long long record) {
+    while (m_durable < record) {
+        if (m_flushing) {
+            m_flushed.wait(lock);
+            continue;
+        }
+
+        m_flushing = true;
+        if (m_commitDelay.count() > 0) {
+            m_gather.wait_for(lock, m_commitDelay, [this] {
+                return (int)m_pending.size() >= m_commitBatch;
+            });
+        }
+        std::vector<JournalRecord> batch;
+        batch.swap(m_pending);
+        unsigned long long upTo = m_appended;
+
+        lock.unlock();
+        std::string encoded;
+        encoded.resize(batch.size() * RECORD_BYTES);
+        for (size_t i = 0; i < batch.size(); i++) {
+            encoded[i * RECORD_BYTES] = batch[i].tag;
+            memcpy(&encoded[i * RECORD_BYTES + 1], &batch[i].value, sizeof(int));
+        }
+        bool failed = false;
+        int error = 0;
+        try {
+            writeAll(m_fd, encoded.data(), encoded.size());
+            if (fdatasync(m_fd) != 0) {
+                throw std::system_error(errno, std::generic_category(), "fdatasync " + m_path);
+            }
+        }
+        catch (const std::system_error& e) {
+            failed = true;
+            error = e.code().value();
+        }
+        lock.lock();
+
+        m_flushing = false;
+        m_flushed.notify_all();
+        if (failed) {
+            // drop whatever part of the batch made it out and keep it for the next leader
+            if (ftruncate(m_fd, (off_t)m_journalBytes) == 0) {
+                lseek(m_fd, (off_t)m_journalBytes, SEEK_SET);
+            }
+            m_pending.insert(m_pending.begin(), batch.begin(), batch.end());
+            throw std::system_error(error, std::generic_category(), "journal " + m_path);
+        }
+        for (const JournalRecord& record : batch) {
+            if (record.tag == 'E') {
+                m_list.enqueue(record.value);
+            }
+        }
+        m_durable = upTo;
+        m_journalBytes += (long long)encoded.size();
+        m_syncs += 1;
+    }
+}
+
+/********************************************
+** Function: writeAll(int fd, const char* data, size_t bytes)
+** Pre-conditions: fd is open for writing
+** Post-conditions: All bytes are written, short writes and EINTR are retried. Throws
+** std::system_error on any other error.
+********************************************/
+void DurableBufferList::writeAll(int fd, const char* data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t written = write(fd, data, bytes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "write " + m_path);
+        }
+        data += written;
+        bytes -= (size_t)written;
+    }
+}
+
+/********************************************
+** Function: replay()
+** Pre-conditions: m_fd is open, m_list is empty
+** Post-conditions: The journal is read in large blocks and its records applied to
+** m_list. An empty file gets the magic and is synced. A torn last record, or anything
+** after an unknown tag, is cut off so new records start on a record boundary. The file
+** position is at the end. Throws std::system_error if the journal cannot be read, cut or
+** synced.
+********************************************/
+void DurableBufferList::replay() {
+    std::vector<char> journal;
+    char block[1 << 16];
+    while (true) {
+        ssize_t got = read(m_fd, block, sizeof(block));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "read " + m_path);
+        }
+        if (got == 0) break;
+        journal.insert(journal.end(), block, block + got);
+    }
+
+    if (journal.size() < sizeof(JOURNAL_MAGIC)) {
+        // new, or torn before the magic was complete
+        if (ftruncate(m_fd, 0) != 0 || lseek(m_fd, 0, SEEK_SET) != 0) {
+            throw std::system_error(errno, std::generic_category(), "reset " + m_path);
+        }
+        writeAll(m_fd, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        if (fsync(m_fd) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fsync " + m_path);
+        }
+        m_syncs += 1;
+        m_journalBytes = sizeof(JOURNAL_MAGIC);
+        return;
+    }
+    if (memcmp(journal.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        throw std::runtime_error(m_path + " is not a BufferList journal");
+    }
+
+    size_t offset = sizeof(JOURNAL_MAGIC);
+    while (offset + RECORD_BYTES <= journal.size()) {
+        int value = 0;
+        memcpy(&value, journal.data() + offset + 1, sizeof(int));
+        if (journal[offset] == 'E') {
+            m_list.enqueue(value);
+        }
+        else if (journal[offset] == 'D') {
+            m_list.consume(value);
+        }
+        else {
+            // garbage after a torn write, nothing after it can be trusted
+            break;
+        }
+        offset += RECORD_BYTES;
+    }
+
+    if (offset != journal.size()) {
+        if (ftruncate(m_fd, (off_t)offset) != 0) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate " + m_path);
+        }
+        lseek(m_fd, (off_t)offset, SEEK_SET);
+    }
+    m_journalBytes = (long long)offset;
+    m_recovered = m_list.count();
+}
+
+/********************************************
+** Function: checkpointLocked()
+** Pre-conditions: m_mutex is held and no leader is syncing
+** Post-conditions: A new journal with the live items is written next to the old one,
+** synced and renamed over it, then the directory is synced. Pending records are part
+** of the snapshot, so every waiter counts as durable and pending items are put in the
+** list. Throws std::system_error if the
+** new journal cannot be written, the old one is kept in that case.
+********************************************/
+void DurableBufferList::checkpointLocked() {
+    std::string temp = m_path + ".checkpoint";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + temp);
+    }
+
+    std::string snapshot(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    snapshot.reserve(sizeof(JOURNAL_MAGIC) + (size_t)RECORD_BYTES * (m_list.count() + m_pending.size()));
+    // read the items in place instead of copying the list while the lock is held
+    int live = m_list.count();
+    int written = 0;
+    while (written < live) {
+        BufferView view = m_list.peekBatch(live - written, written);
+        for (int s = 0; s < view.spanCount; s++) {
+            for (int i = 0; i < view.spans[s].length; i++) {
+                char record[RECORD_BYTES];
+                record[0] = 'E';
+                memcpy(record + 1, &view.spans[s].data[i], sizeof(int));
+                snapshot.append(record, RECORD_BYTES);
+            }
+        }
+        written += view.total;
+    }
+    // pending dequeues are already applied to m_list, pending enqueues come after it
+    for (const JournalRecord& pending : m_pending) {
+        if (pending.tag == 'E') {
+            char record[RECORD_BYTES];
+            record[0] = 'E';
+            memcpy(record + 1, &pending.value, sizeof(int));
+            snapshot.append(record, RECORD_BYTES);
+        }
+    }
+
+    try {
+        writeAll(fd, snapshot.data(), snapshot.size());
+        if (fsync(fd) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fsync " + temp);
+        }
+    }
+    catch (...) {
+        close(fd);
+        unlink(temp.c_str());
+        throw;
+    }
+    if (rename(temp.c_str(), m_path.c_str()) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "rename " + temp);
+    }
+
+    // the rename is only durable once the directory is synced
+    size_t slash = m_path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? "." : m_path.substr(0, slash + 1);
+    int dirfd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd >= 0) {
+        fsync(dirfd);
+        close(dirfd);
+    }
+
+    close(m_fd);
+    m_fd = fd;
+    for (const JournalRecord& pending : m_pending) {
+        if (pending.tag == 'E') {
+            m_list.enqueue(pending.value);
+        }
+    }
+    m_pending.clear();
+    m_durable = m_appended;
+    m_journalBytes = (long long)snapshot.size();
+    m_dequeuesSinceCheckpoint = 0;
+    m_syncs += 1;
+    m_flushed.notify_all();
+}
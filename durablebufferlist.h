@@ -0,0 +1,89 @@
+/******************************************************************************************
+** File: durablebufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the DurableBufferList class.
+** This class is a BufferList backed by a write-ahead journal file. enqueue returns only
+** once its item is on disk, and the item can only be dequeued from then on; an enqueue
+** that throws leaves neither the item nor its record behind. Concurrent enqueuers share
+** one fsync: the first waiter
+** becomes the leader, optionally waits up to the commit delay for more records, and
+** syncs the whole batch for everybody (group commit). Dequeues are journaled without
+** waiting, so after a crash an item may be delivered again but an acknowledged item is
+** never lost. Checkpoints rewrite the journal as just the live items, which keeps it
+** short, and opening an existing journal replays it in one pass.
+******************************************************************************************/
+
+
+
+#ifndef DURABLEBUFFERLIST_H
+#define DURABLEBUFFERLIST_H
+#include "bufferlist.h"
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const int DEFAULT_CHECKPOINT_INTERVAL = 65536;  // dequeues between automatic checkpoints
+class DurableBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of DurableBufferList
+    friend class Tester;//Tester will have access to private members of DurableBufferList
+    DurableBufferList(const std::string & path, int minBufCapacity); //opens or creates the journal, replays it
+    ~DurableBufferList();               //syncs pending records and closes the journal
+    DurableBufferList(const DurableBufferList & rhs) = delete;  //the journal has one owner
+    DurableBufferList & operator=(const DurableBufferList & rhs) = delete;
+    void enqueue(const int & data);     //add data, returns once it is durable
+    int dequeue();                      //remove data, the dequeue becomes durable with the next sync
+    bool empty();                       //returns true if there is nothing to dequeue
+    int count();                        //number of items in the list
+    void setGroupCommit(std::chrono::microseconds delay, int batch); //how long a leader waits for a batch
+    void setCheckpointInterval(int dequeues);   //checkpoint after this many dequeues, 0 turns it off
+    void sync();                        //makes every record so far durable
+    void checkpoint();                  //rewrites the journal as the live items only
+    unsigned long long syncs();         //number of fsyncs so far, checkpoints included
+    long long journalBytes();           //current size of the journal file
+    int recovered();                    //number of items the constructor found in the journal
+
+
+    private:
+    // a record that is not written yet, items of 'E' records are not in m_list yet
+    struct JournalRecord{
+        char tag;                   // 'E' or 'D'
+        int value;                  // the item enqueued, or the number of items dequeued
+        unsigned long long number;  // position among all records appended, from 1
+    };
+    BufferList m_list;          //the durable items, guarded by m_mutex
+    std::string m_path;         //journal file
+    int m_fd;                   //journal file descriptor, opened for appending
+    std::mutex m_mutex;         //guards everything below
+    std::condition_variable m_flushed;  //signals the end of a sync
+    std::condition_variable m_gather;   //signals a leader that its batch is full
+    std::vector<JournalRecord> m_pending;   //records not written yet, oldest first
+    unsigned long long m_appended;  //records appended so far
+    unsigned long long m_durable;   //records known to be on disk
+    bool m_flushing;            //whether a leader is writing and syncing
+    std::chrono::microseconds m_commitDelay;    //longest time a leader waits for more records
+    int m_commitBatch;          //records that end a leader's wait early
+    int m_checkpointInterval;   //dequeues between automatic checkpoints, 0 for none
+    int m_dequeuesSinceCheckpoint;  //dequeues journaled since the last checkpoint
+    unsigned long long m_syncs; //fsyncs so far
+    long long m_journalBytes;   //bytes in the journal file, pending records excluded
+    int m_recovered;            //items replayed by the constructor
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void appendRecord(char tag, int value);     //adds a record to m_pending
+    void waitDurable(std::unique_lock<std::mutex> & lock, unsigned long long record); //group commit
+    void writeAll(int fd, const char * data, size_t bytes); //write loop, throws on error
+    void replay();              //reads the journal into m_list and cuts off a torn last record
+    void checkpointLocked();    //checkpoint with m_mutex held and no leader running
+};
+#endif
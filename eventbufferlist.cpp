@@ -0,0 +1,173 @@
+/******************************************************************************************
+** File: eventbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the EventBufferList class.
+** The eventfd is readable exactly while the list is non-empty. It is written and read
+** under the lock, so a consumer that empties the list can never clear a signal that a
+** producer raised for a newer item.
+******************************************************************************************/
+
+#include "eventbufferlist.h"
+#include <system_error>
+#include <cerrno>
+#include <cstdint>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+/********************************************
+** Function: EventBufferList(int minBufCapacity)
+** Pre-conditions: minBufCapacity is an integer larger than 0
+** Post-conditions: An empty list with an unreadable, non-blocking eventfd is created.
+** Throws std::system_error if the eventfd cannot be opened.
+********************************************/
+EventBufferList::EventBufferList(int minBufCapacity) : m_list(minBufCapacity) {
+    m_fd = -1;
+    m_signaled = false;
+    m_signals = 0;
+    m_acknowledgements = 0;
+#ifdef __linux__
+    m_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+#endif
+}
+
+/********************************************
+** Function: ~EventBufferList()
+** Pre-conditions: The eventfd is no longer registered with epoll
+** Post-conditions: The eventfd is closed, the items are deallocated
+********************************************/
+EventBufferList::~EventBufferList() {
+#ifdef __linux__
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+#endif
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: data is added to the list. If the eventfd was not readable it is
+** signaled, every other enqueue costs no system call.
+********************************************/
+void EventBufferList::enqueue(const int& data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_list.enqueue(data);
+    if (!m_signaled) {
+        signal();
+    }
+}
+
+/********************************************
+** Function: dequeueBatch(int* out, int max)
+** Pre-conditions: out has room for max items
+** Post-conditions: Up to max oldest items are moved to out, oldest first. If that
+** empties the list the eventfd is read so it is no longer readable. Returns how many
+** items were moved, 0 if the list was empty.
+********************************************/
+int EventBufferList::dequeueBatch(int* out, int max) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int moved = 0;
+    while (moved < max && !m_list.empty()) {
+        BufferView view = m_list.peekBatch(max - moved);
+        for (int s = 0; s < view.spanCount; s++) {
+            for (int i = 0; i < view.spans[s].length; i++) {
+                out[moved++] = view.spans[s].data[i];
+            }
+        }
+        m_list.consume(view.total);
+    }
+    if (m_signaled && m_list.empty()) {
+        acknowledge();
+    }
+    return moved;
+}
+
+/********************************************
+** Function: fd()
+** Pre-conditions: None
+** Post-conditions: Returns the eventfd, readable (EPOLLIN) while the list holds items,
+** or -1 on systems without eventfd
+********************************************/
+int EventBufferList::fd() {
+    return m_fd;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items in the list
+********************************************/
+int EventBufferList::count() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_list.count();
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if there is nothing to dequeue
+********************************************/
+bool EventBufferList::empty() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_list.empty();
+}
+
+/********************************************
+** Function: signals()
+** Pre-conditions: None
+** Post-conditions: Returns the number of eventfd writes so far
+********************************************/
+unsigned long long EventBufferList::signals() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_signals;
+}
+
+/********************************************
+** Function: acknowledgements()
+** Pre-conditions: None
+** Post-conditions: Returns the number of eventfd reads so far
+********************************************/
+unsigned long long EventBufferList::acknowledgements() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_acknowledgements;
+}
+
+/********************************************
+** Function: signal()
+** Pre-conditions: m_mutex is held and the eventfd is not readable
+** Post-conditions: The eventfd counter is non-zero
+********************************************/
+void EventBufferList::signal() {
+    m_signaled = true;
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t written = write(m_fd, &one, sizeof(one));
+    (void)written;  // cannot fail, the counter is 0 and the fd is open
+    m_signals += 1;
+#endif
+}
+
+/********************************************
+** Function: acknowledge()
+** Pre-conditions: m_mutex is held and the eventfd is readable
+** Post-conditions: The eventfd counter is 0
+********************************************/
+void EventBufferList::acknowledge() {
+    m_signaled = false;
+#ifdef __linux__
+    uint64_t value = 0;
+    ssize_t bytes = read(m_fd, &value, sizeof(value));
+    (void)bytes;    // cannot block, the counter is non-zero
+    m_acknowledgements += 1;
+#endif
+}
@@ -0,0 +1,112 @@
+/******************************************************************************************
+** File: executor.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the SimpleExecutor class.
+** Coroutines are resumed outside the lock, so a resumed coroutine may post again.
+******************************************************************************************/
+
+#include "executor.h"
+#ifdef __cpp_impl_coroutine
+
+/********************************************
+** Function: SimpleExecutor()
+** Pre-conditions: None
+** Post-conditions: An executor with an empty queue is created
+********************************************/
+SimpleExecutor::SimpleExecutor() {
+    m_stopped = false;
+}
+
+/********************************************
+** Function: ~SimpleExecutor()
+** Pre-conditions: run is not executing
+** Post-conditions: Queued coroutines that were never resumed are destroyed
+********************************************/
+SimpleExecutor::~SimpleExecutor() {
+    for (std::coroutine_handle<> handle : m_ready) {
+        handle.destroy();
+    }
+}
+
+/********************************************
+** Function: post(std::coroutine_handle<> handle)
+** Pre-conditions: handle is a suspended coroutine
+** Post-conditions: handle is queued and a thread blocked in run is woken
+********************************************/
+void SimpleExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(handle);
+    }
+    m_posted.notify_one();
+}
+
+/********************************************
+** Function: runPending()
+** Pre-conditions: None
+** Post-conditions: Every coroutine queued when the call started is resumed on the
+** calling thread, oldest first. Returns how many were resumed.
+********************************************/
+int SimpleExecutor::runPending() {
+    std::deque<std::coroutine_handle<>> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        batch.swap(m_ready);
+    }
+    for (std::coroutine_handle<> handle : batch) {
+        handle.resume();
+    }
+    return (int)batch.size();
+}
+
+/********************************************
+** Function: run()
+** Pre-conditions: Only one thread runs the executor
+** Post-conditions: Posted coroutines are resumed on the calling thread as they arrive,
+** until stop was called and the queue is empty
+********************************************/
+void SimpleExecutor::run() {
+    while (true) {
+        std::coroutine_handle<> handle;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_posted.wait(lock, [this] { return m_stopped || !m_ready.empty(); });
+            if (m_ready.empty()) {
+                m_stopped = false;
+                return;
+            }
+            handle = m_ready.front();
+            m_ready.pop_front();
+        }
+        handle.resume();
+    }
+}
+
+/********************************************
+** Function: stop()
+** Pre-conditions: None
+** Post-conditions: run returns once the queue is empty
+********************************************/
+void SimpleExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+    }
+    m_posted.notify_all();
+}
+
+/********************************************
+** Function: pending()
+** Pre-conditions: None
+** Post-conditions: Returns the number of queued coroutines
+********************************************/
+int SimpleExecutor::pending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_ready.size();
+}
+#endif
@@ -0,0 +1,58 @@
+/******************************************************************************************
+** File: executor.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the Executor interface and the SimpleExecutor
+** class. An Executor decides where a suspended coroutine is resumed. SimpleExecutor
+** queues the coroutines posted to it and resumes them one by one on the single thread
+** that runs it. Coroutines need C++20, the file is empty in older language modes.
+******************************************************************************************/
+
+
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+class Executor{
+    public:
+    virtual ~Executor() {}
+    virtual void post(std::coroutine_handle<> handle) = 0;  //schedules handle to be resumed, may be called from any thread
+};
+
+class SimpleExecutor : public Executor{
+    public:
+    friend class Grader;//Grader will have access to private members of SimpleExecutor
+    friend class Tester;//Tester will have access to private members of SimpleExecutor
+    SimpleExecutor();       //constructor
+    ~SimpleExecutor();      //destructor, destroys coroutines that were never resumed
+    SimpleExecutor(const SimpleExecutor & rhs) = delete;        //queued coroutines are not copyable
+    SimpleExecutor & operator=(const SimpleExecutor & rhs) = delete;
+    void post(std::coroutine_handle<> handle) override; //queues handle
+    int runPending();       //resumes every queued coroutine, returns how many
+    void run();             //resumes coroutines as they are posted until stop is called
+    void stop();            //makes run return once the queue is empty
+    int pending();          //number of queued coroutines
+
+
+    private:
+    std::deque<std::coroutine_handle<>> m_ready;    //coroutines waiting to be resumed, oldest first
+    std::mutex m_mutex;                             //guards m_ready and m_stopped
+    std::condition_variable m_posted;               //signals post and stop to run
+    bool m_stopped;                                 //set by stop, cleared when run returns
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+};
+#endif
+#endif
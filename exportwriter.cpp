@@ -0,0 +1,171 @@
+/******************************************************************************************
+** File: exportwriter.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the ExportWriter class.
+** Numbers are formatted straight into the buffer, nothing is locale dependent and
+** nothing is flushed until the buffer is full or flush is called.
+******************************************************************************************/
+
+#include "exportwriter.h"
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
+
+const size_t MAX_INT_CHARS = 20;    // longest decimal long long, sign included
+
+/********************************************
+** Function: ExportWriter(int fd, size_t capacity)
+** Pre-conditions: fd is open for writing
+** Post-conditions: A writer with a capacity byte buffer that writes to fd is created
+********************************************/
+ExportWriter::ExportWriter(int fd, size_t capacity) {
+    m_capacity = (capacity < MAX_INT_CHARS) ? MAX_INT_CHARS : capacity;
+    m_buffer = new char[m_capacity];
+    m_used = 0;
+    m_fd = fd;
+    m_stream = nullptr;
+    m_written = 0;
+}
+
+/********************************************
+** Function: ExportWriter(std::ostream& stream, size_t capacity)
+** Pre-conditions: stream outlives the writer
+** Post-conditions: A writer with a capacity byte buffer that writes to stream is created
+********************************************/
+ExportWriter::ExportWriter(std::ostream& stream, size_t capacity) {
+    m_capacity = (capacity < MAX_INT_CHARS) ? MAX_INT_CHARS : capacity;
+    m_buffer = new char[m_capacity];
+    m_used = 0;
+    m_fd = -1;
+    m_stream = &stream;
+    m_written = 0;
+}
+
+/********************************************
+** Function: ~ExportWriter()
+** Pre-conditions: None
+** Post-conditions: Buffered text is flushed, errors are ignored, the buffer is freed
+********************************************/
+ExportWriter::~ExportWriter() {
+    try {
+        flush();
+    }
+    catch (...) {
+        // a destructor cannot report a failed write
+    }
+    delete[] m_buffer;
+}
+
+/********************************************
+** Function: append(const char* text)
+** Pre-conditions: text is zero terminated
+** Post-conditions: text is buffered
+********************************************/
+void ExportWriter::append(const char* text) {
+    append(text, strlen(text));
+}
+
+/********************************************
+** Function: append(const char* text, size_t length)
+** Pre-conditions: text has length characters
+** Post-conditions: text is buffered. Text larger than the buffer is written through.
+********************************************/
+void ExportWriter::append(const char* text, size_t length) {
+    if (m_used + length > m_capacity) {
+        flush();
+        if (length > m_capacity) {
+            writeOut(text, length);
+            return;
+        }
+    }
+    memcpy(m_buffer + m_used, text, length);
+    m_used += length;
+}
+
+/********************************************
+** Function: append(char c)
+** Pre-conditions: None
+** Post-conditions: c is buffered
+********************************************/
+void ExportWriter::append(char c) {
+    if (m_used == m_capacity) {
+        flush();
+    }
+    m_buffer[m_used++] = c;
+}
+
+/********************************************
+** Function: appendInt(long long value)
+** Pre-conditions: None
+** Post-conditions: value is buffered in decimal, formatted with std::to_chars
+********************************************/
+void ExportWriter::appendInt(long long value) {
+    if (m_capacity - m_used < MAX_INT_CHARS) {
+        flush();
+    }
+    std::to_chars_result result = std::to_chars(m_buffer + m_used, m_buffer + m_capacity, value);
+    m_used = (size_t)(result.ptr - m_buffer);
+}
+
+/********************************************
+** Function: flush()
+** Pre-conditions: None
+** Post-conditions: Every buffered character is handed to the sink and the buffer is
+** empty. Throws std::system_error if writing to the file descriptor fails.
+********************************************/
+void ExportWriter::flush() {
+    if (m_used == 0) return;
+    size_t length = m_used;
+    m_used = 0;
+    writeOut(m_buffer, length);
+}
+
+/********************************************
+** Function: bytesWritten()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes handed to the sink so far, buffered ones excluded
+********************************************/
+long long ExportWriter::bytesWritten() {
+    return m_written;
+}
+
+/********************************************
+** Function: plainCapacity(int buffers, long long items)
+** Pre-conditions: buffers and items are 0 or larger
+** Post-conditions: Returns a buffer size that holds a plain export of buffers buffers
+** holding items items in total without flushing, but no more than EXPORT_BUFFER_BYTES
+********************************************/
+size_t ExportWriter::plainCapacity(int buffers, long long items) {
+    size_t bytes = (size_t)buffers * PLAIN_LINE_BYTES + (size_t)items * PLAIN_ITEM_BYTES;
+    return (bytes < EXPORT_BUFFER_BYTES) ? bytes : EXPORT_BUFFER_BYTES;
+}
+
+/********************************************
+** Function: writeOut(const char* data, size_t length)
+** Pre-conditions: None
+** Post-conditions: data is written to the stream, or to the file descriptor retrying
+** short writes and EINTR. Throws std::system_error on any other write error.
+********************************************/
+void ExportWriter::writeOut(const char* data, size_t length) {
+    m_written += (long long)length;
+    if (m_stream != nullptr) {
+        m_stream->write(data, (std::streamsize)length);
+        return;
+    }
+    while (length > 0) {
+        ssize_t written = write(m_fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "export write");
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
@@ -0,0 +1,64 @@
+/******************************************************************************************
+** File: exportwriter.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the ExportWriter class.
+** This class collects formatted text in one large character buffer, formatting numbers
+** with std::to_chars, and hands it to a file descriptor or an ostream in big chunks.
+** Buffer::exportTo and BufferList::exportTo write through it; dump() is a plain export
+** to std::cout through a writer sized to the content. A writer can be kept and reused so
+** its buffer is allocated once.
+******************************************************************************************/
+
+
+
+#ifndef EXPORTWRITER_H
+#define EXPORTWRITER_H
+#include <ostream>
+#include <cstddef>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const size_t EXPORT_BUFFER_BYTES = 1 << 20;   // default size of the character buffer
+const size_t PLAIN_LINE_BYTES = 96;     // longest plain export line without its items
+const size_t PLAIN_ITEM_BYTES = 24;     // longest plain export item, "-2147483648[2147483647] "
+enum ExportFormat{
+    EXPORT_PLAIN,   // the dump() layout, one line per buffer
+    EXPORT_CSV,     // one row per item, with the buffer's metadata in every row
+    EXPORT_JSON     // one object per buffer, metadata and an items array
+};
+class ExportWriter{
+    public:
+    friend class Grader;//Grader will have access to private members of ExportWriter
+    friend class Tester;//Tester will have access to private members of ExportWriter
+    ExportWriter(int fd, size_t capacity = EXPORT_BUFFER_BYTES);    //writes to a file descriptor
+    ExportWriter(std::ostream & stream, size_t capacity = EXPORT_BUFFER_BYTES); //writes to a stream
+    ~ExportWriter();                //destructor, flushes what is left
+    ExportWriter(const ExportWriter & rhs) = delete;    //one owner per buffer and sink
+    ExportWriter & operator=(const ExportWriter & rhs) = delete;
+    void append(const char * text); //adds a zero terminated string
+    void append(const char * text, size_t length);  //adds length characters
+    void append(char c);            //adds one character
+    void appendInt(long long value);//adds value in decimal
+    void flush();                   //hands everything buffered to the sink
+    long long bytesWritten();       //bytes handed to the sink so far
+    static size_t plainCapacity(int buffers, long long items);  //buffer size for a plain export, at most EXPORT_BUFFER_BYTES
+
+
+    private:
+    char *m_buffer;         //the character buffer
+    size_t m_capacity;      //size of m_buffer
+    size_t m_used;          //characters waiting in m_buffer
+    int m_fd;               //sink file descriptor, -1 when writing to m_stream
+    std::ostream *m_stream; //sink stream, nullptr when writing to m_fd
+    long long m_written;    //bytes handed to the sink
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void writeOut(const char * data, size_t length);    //sends data straight to the sink
+};
+#endif
@@ -0,0 +1,187 @@
+/******************************************************************************************
+** File: hugepageresource.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the HugePageResource class.
+** MAP_HUGETLB only succeeds when the administrator reserved huge pages, so it is tried
+** first and a plain mapping is used otherwise. The plain mapping is over-allocated by
+** one huge page and trimmed so the block starts on a 2 MiB boundary, which lets the
+** kernel back it with transparent huge pages. On other systems every block goes upstream.
+******************************************************************************************/
+
+#include "hugepageresource.h"
+#include <cstdint>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/********************************************
+** Function: HugePageResource(size_t threshold, std::pmr::memory_resource* upstream)
+** Pre-conditions: upstream is not nullptr
+** Post-conditions: A resource is created that maps blocks of threshold bytes or more
+********************************************/
+HugePageResource::HugePageResource(size_t threshold, std::pmr::memory_resource* upstream) {
+    m_upstream = upstream;
+    m_threshold = threshold;
+    m_useHugeTlb = true;
+    m_lastPath = PAGE_PATH_UPSTREAM;
+    for (int i = 0; i < 4; i++) {
+        m_counts[i] = 0;
+    }
+}
+
+/********************************************
+** Function: ~HugePageResource()
+** Pre-conditions: None
+** Post-conditions: Every region that is still mapped is unmapped
+********************************************/
+HugePageResource::~HugePageResource() {
+#ifdef __linux__
+    for (std::unordered_map<void*, size_t>::iterator it = m_mappings.begin(); it != m_mappings.end(); ++it) {
+        munmap(it->first, it->second);
+    }
+#endif
+    m_mappings.clear();
+}
+
+/********************************************
+** Function: useHugeTlb(bool enabled)
+** Pre-conditions: None
+** Post-conditions: MAP_HUGETLB is tried first only when enabled
+********************************************/
+void HugePageResource::useHugeTlb(bool enabled) {
+    m_useHugeTlb = enabled;
+}
+
+/********************************************
+** Function: lastPath()
+** Pre-conditions: None
+** Post-conditions: Returns the path taken by the most recent allocation
+********************************************/
+HugePagePath HugePageResource::lastPath() {
+    return m_lastPath;
+}
+
+/********************************************
+** Function: allocations(HugePagePath path)
+** Pre-conditions: None
+** Post-conditions: Returns how many allocations took path
+********************************************/
+int HugePageResource::allocations(HugePagePath path) {
+    return m_counts[path];
+}
+
+/********************************************
+** Function: report(std::ostream& out)
+** Pre-conditions: None
+** Post-conditions: The number of allocations per path is printed to out
+********************************************/
+void HugePageResource::report(std::ostream& out) {
+    out << "Huge page resource: " << m_counts[PAGE_PATH_HUGETLB] << " hugetlb, "
+        << m_counts[PAGE_PATH_TRANSPARENT] << " transparent, "
+        << m_counts[PAGE_PATH_FALLBACK] << " fallback, "
+        << m_counts[PAGE_PATH_UPSTREAM] << " below threshold" << std::endl;
+}
+
+/********************************************
+** Function: mapHuge(size_t length, HugePagePath& path)
+** Pre-conditions: length is a multiple of HUGE_PAGE_SIZE
+** Post-conditions: Returns a 2 MiB aligned mapping of length bytes and sets path,
+** or returns nullptr if nothing could be mapped
+********************************************/
+void* HugePageResource::mapHuge(size_t length, HugePagePath& path) {
+#ifdef __linux__
+#ifdef MAP_HUGETLB
+    if (m_useHugeTlb) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            path = PAGE_PATH_HUGETLB;
+            return p;
+        }
+    }
+#endif
+    // over-allocate by one huge page, then trim both ends to a 2 MiB boundary
+    size_t padded = length + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    uintptr_t tail = aligned + length;
+    uintptr_t end = start + padded;
+    if (end > tail) {
+        munmap(reinterpret_cast<void*>(tail), end - tail);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+#endif
+    path = PAGE_PATH_TRANSPARENT;
+    return reinterpret_cast<void*>(aligned);
+#else
+    (void)length;
+    (void)path;
+    return nullptr;
+#endif
+}
+
+/********************************************
+** Function: do_allocate(size_t bytes, size_t alignment)
+** Pre-conditions: alignment is at most HUGE_PAGE_SIZE
+** Post-conditions: Blocks of at least m_threshold bytes are mapped on huge pages,
+** anything else or anything that fails to map comes from upstream
+********************************************/
+void* HugePageResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes >= m_threshold && alignment <= HUGE_PAGE_SIZE) {
+        size_t length = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        HugePagePath path = PAGE_PATH_FALLBACK;
+        void* p = mapHuge(length, path);
+        if (p != nullptr) {
+            m_mappings[p] = length;
+            m_lastPath = path;
+            m_counts[path]++;
+            return p;
+        }
+        m_lastPath = PAGE_PATH_FALLBACK;
+        m_counts[PAGE_PATH_FALLBACK]++;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    m_lastPath = PAGE_PATH_UPSTREAM;
+    m_counts[PAGE_PATH_UPSTREAM]++;
+    return m_upstream->allocate(bytes, alignment);
+}
+
+/********************************************
+** Function: do_deallocate(void* p, size_t bytes, size_t alignment)
+** Pre-conditions: p was returned by this resource for the same bytes and alignment
+** Post-conditions: Mapped blocks are unmapped, others go back to upstream
+********************************************/
+void HugePageResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::unordered_map<void*, size_t>::iterator it = m_mappings.find(p);
+    if (it != m_mappings.end()) {
+#ifdef __linux__
+        munmap(p, it->second);
+#endif
+        m_mappings.erase(it);
+        return;
+    }
+    m_upstream->deallocate(p, bytes, alignment);
+}
+
+/********************************************
+** Function: do_is_equal(const std::pmr::memory_resource& other)
+** Pre-conditions: None
+** Post-conditions: Returns true only for the same resource
+********************************************/
+bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,64 @@
+/******************************************************************************************
+** File: hugepageresource.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the HugePageResource class.
+** This class is a std::pmr::memory_resource for BufferLists with large buffers.
+** Blocks at or above a size threshold are mapped in 2 MiB aligned regions, first with
+** MAP_HUGETLB and otherwise with transparent huge page advice, so deep queues take
+** fewer TLB misses. Smaller blocks and failed mappings go to the upstream resource.
+******************************************************************************************/
+
+
+
+#ifndef HUGEPAGERESOURCE_H
+#define HUGEPAGERESOURCE_H
+#include <memory_resource>
+#include <unordered_map>
+#include <iostream>
+#include <cstddef>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // size and alignment of a huge page
+enum HugePagePath{
+    PAGE_PATH_UPSTREAM,     // below the threshold, allocated by upstream
+    PAGE_PATH_HUGETLB,      // mapped with MAP_HUGETLB from the reserved huge page pool
+    PAGE_PATH_TRANSPARENT,  // mapped 2 MiB aligned and advised with MADV_HUGEPAGE
+    PAGE_PATH_FALLBACK      // mapping failed, allocated by upstream
+};
+class HugePageResource : public std::pmr::memory_resource{
+    public:
+    friend class Grader;//Grader will have access to private members of HugePageResource
+    friend class Tester;//Tester will have access to private members of HugePageResource
+    HugePageResource(size_t threshold = HUGE_PAGE_SIZE,
+                     std::pmr::memory_resource * upstream = std::pmr::get_default_resource()); //constructor
+    ~HugePageResource();                        //destructor, unmaps anything still mapped
+    HugePageResource(const HugePageResource & rhs) = delete;            //a resource owns its mappings
+    HugePageResource & operator=(const HugePageResource & rhs) = delete;
+    void useHugeTlb(bool enabled);  //try MAP_HUGETLB before transparent huge pages, on by default
+    HugePagePath lastPath();        //path taken by the most recent allocation
+    int allocations(HugePagePath path); //number of allocations that took path
+    void report(std::ostream & out);    //prints how many allocations took each path
+
+
+    private:
+    std::pmr::memory_resource *m_upstream;  // small blocks and fallbacks
+    size_t m_threshold;     // smallest block that is mapped
+    bool m_useHugeTlb;      // whether MAP_HUGETLB is tried first
+    HugePagePath m_lastPath;    // path of the last allocation
+    int m_counts[4];        // allocations per path
+    std::unordered_map<void*, size_t> m_mappings; // mapped blocks and their mapped length
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+    void* mapHuge(size_t length, HugePagePath & path);  //maps length bytes, nullptr on failure
+};
+#endif
@@ -0,0 +1,273 @@
+/******************************************************************************************
+** File: ingestreader.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the IngestReader class.
+** A token is never split between two parses: whatever follows the last separator of a
+** block is moved to the start of the block and completed by the next read.
+******************************************************************************************/
+
+#include "ingestreader.h"
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+const size_t MIN_INGEST_BLOCK = 64;     // room for the longest int token and then some
+
+/********************************************
+** Function: isSeparator(char c)
+** Pre-conditions: None
+** Post-conditions: Returns true if c may come between two values
+********************************************/
+static inline bool isSeparator(char c) {
+    return c == '\n' || c == ',' || c == ' ' || c == '\r' || c == '\t';
+}
+
+/********************************************
+** Function: IngestReader(int fd, size_t blockBytes)
+** Pre-conditions: fd is open for reading
+** Post-conditions: A reader with a blockBytes read block is created
+********************************************/
+IngestReader::IngestReader(int fd, size_t blockBytes) {
+    m_blockBytes = (blockBytes < MIN_INGEST_BLOCK) ? MIN_INGEST_BLOCK : blockBytes;
+    m_block = new char[m_blockBytes];
+    m_fd = fd;
+    m_read = 0;
+    m_reservation.spanCount = 0;
+    m_reservation.total = 0;
+    m_span = 0;
+    m_offset = 0;
+    m_filled = 0;
+}
+
+/********************************************
+** Function: ~IngestReader()
+** Pre-conditions: None
+** Post-conditions: The read block is freed
+********************************************/
+IngestReader::~IngestReader() {
+    delete[] m_block;
+}
+
+/********************************************
+** Function: readText(BufferList& list)
+** Pre-conditions: No reserve is outstanding on list
+** Post-conditions: Every value up to the end of input is added to the back of list in
+** file order, and the number added is returned. Values are decimal ints separated by
+** any run of commas, spaces, tabs and line breaks. Throws invalid_argument for any
+** other character and out_of_range for a value that does not fit an int; the values
+** before it are kept.
+********************************************/
+long long IngestReader::readText(BufferList& list) {
+    long long added = 0;
+    long long offset = 0;   // file offset of m_block[0]
+    size_t carry = 0;       // bytes of an unfinished token at the start of m_block
+
+    try {
+        while (true) {
+            size_t got = readSome(m_block + carry, m_blockBytes - carry);
+            size_t end = carry + got;
+            if (got == 0) {
+                added += parseText(list, m_block, end, offset);
+                break;
+            }
+
+            // only complete tokens are parsed, the tail waits for the next read
+            size_t limit = end;
+            while (limit > 0 && !isSeparator(m_block[limit - 1])) {
+                limit--;
+            }
+            if (limit == 0 && end == m_blockBytes) {
+                throw std::invalid_argument("Token longer than the ingest block at offset "
+                                            + std::to_string(offset));
+            }
+            added += parseText(list, m_block, limit, offset);
+            carry = end - limit;
+            memmove(m_block, m_block + limit, carry);
+            offset += (long long)limit;
+        }
+    }
+    catch (...) {
+        finish(list);
+        throw;
+    }
+    finish(list);
+    return added;
+}
+
+/********************************************
+** Function: readBinary(BufferList& list)
+** Pre-conditions: No reserve is outstanding on list
+** Post-conditions: Every 4 byte little endian value up to the end of input is read
+** straight into reserved slots of list, and the number added is returned. Throws
+** invalid_argument if the input ends inside a value; the whole values are kept.
+********************************************/
+long long IngestReader::readBinary(BufferList& list) {
+    long long added = 0;
+    int chunk = (int)(m_blockBytes / sizeof(int));
+    size_t partial = 0;     // bytes of a value left over at the end of input
+
+    while (partial == 0) {
+        BufferReservation reservation = list.reserve(chunk);
+        if (reservation.total == 0) {
+            // a full bounded list hands out no slots, it overwrites through enqueue
+            int value;
+            size_t got = 0;
+            while (got < sizeof(int)) {
+                size_t more = readSome((char*)&value + got, sizeof(int) - got);
+                if (more == 0) break;
+                got += more;
+            }
+            if (got < sizeof(int)) {
+                partial = got;
+                break;
+            }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            value = (int)__builtin_bswap32((unsigned int)value);
+#endif
+            list.enqueue(value);
+            added++;
+            continue;
+        }
+
+        int written = 0;
+        bool atEnd = false;
+        for (int s = 0; s < reservation.spanCount && !atEnd; s++) {
+            char* data = (char*)reservation.spans[s].data;
+            size_t want = (size_t)reservation.spans[s].length * sizeof(int);
+            size_t got = 0;
+            while (got < want) {
+                size_t more = readSome(data + got, want - got);
+                if (more == 0) {
+                    atEnd = true;
+                    break;
+                }
+                got += more;
+            }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            for (size_t i = 0; i < got / sizeof(int); i++) {
+                int* item = reservation.spans[s].data + i;
+                *item = (int)__builtin_bswap32((unsigned int)*item);
+            }
+#endif
+            written += (int)(got / sizeof(int));
+            partial = got % sizeof(int);
+        }
+        list.commit(written);
+        added += written;
+        if (atEnd) break;
+    }
+
+    if (partial != 0) {
+        throw std::invalid_argument("Input ends inside a value, " + std::to_string(partial)
+                                    + " bytes left over");
+    }
+    return added;
+}
+
+/********************************************
+** Function: bytesRead()
+** Pre-conditions: None
+** Post-conditions: Returns the bytes read from the file descriptor so far
+********************************************/
+long long IngestReader::bytesRead() {
+    return m_read;
+}
+
+/********************************************
+** Function: readSome(char* data, size_t length)
+** Pre-conditions: data has room for length bytes
+** Post-conditions: One read of up to length bytes into data, retried on EINTR. Returns
+** the bytes read, 0 at the end of input. Throws std::system_error on a read error.
+********************************************/
+size_t IngestReader::readSome(char* data, size_t length) {
+    while (true) {
+        ssize_t got = read(m_fd, data, length);
+        if (got >= 0) {
+            m_read += got;
+            return (size_t)got;
+        }
+        if (errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "ingest read");
+        }
+    }
+}
+
+/********************************************
+** Function: put(BufferList& list, int value)
+** Pre-conditions: None
+** Post-conditions: value is written into the next reserved slot. A full reservation is
+** committed and a new one taken; a list that hands out no slots gets value by enqueue.
+********************************************/
+void IngestReader::put(BufferList& list, int value) {
+    if (m_filled == m_reservation.total) {
+        finish(list);
+        m_reservation = list.reserve(INGEST_CHUNK);
+        if (m_reservation.total == 0) {
+            list.enqueue(value);
+            return;
+        }
+    }
+    if (m_offset == m_reservation.spans[m_span].length) {
+        m_span++;
+        m_offset = 0;
+    }
+    m_reservation.spans[m_span].data[m_offset++] = value;
+    m_filled++;
+}
+
+/********************************************
+** Function: finish(BufferList& list)
+** Pre-conditions: None
+** Post-conditions: The slots written so far are committed and no reservation is held
+********************************************/
+void IngestReader::finish(BufferList& list) {
+    if (m_reservation.total > 0) {
+        list.commit(m_filled);
+    }
+    m_reservation.spanCount = 0;
+    m_reservation.total = 0;
+    m_span = 0;
+    m_offset = 0;
+    m_filled = 0;
+}
+
+/********************************************
+** Function: parseText(BufferList& list, const char* data, size_t length, long long offset)
+** Pre-conditions: data[0, length) holds only whole tokens, offset is its file offset
+** Post-conditions: Every value in data is put into list, and the count is returned.
+** Throws invalid_argument or out_of_range, naming the file offset, for a bad token.
+********************************************/
+long long IngestReader::parseText(BufferList& list, const char* data, size_t length, long long offset) {
+    long long added = 0;
+    const char* ptr = data;
+    const char* end = data + length;
+    while (ptr < end) {
+        if (isSeparator(*ptr)) {
+            ptr++;
+            continue;
+        }
+        int value;
+        std::from_chars_result result = std::from_chars(ptr, end, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            throw std::out_of_range("Value does not fit an int at offset "
+                                    + std::to_string(offset + (ptr - data)));
+        }
+        if (result.ec != std::errc() || (result.ptr < end && !isSeparator(*result.ptr))) {
+            throw std::invalid_argument("Not an int at offset "
+                                        + std::to_string(offset + (ptr - data)));
+        }
+        put(list, value);
+        added++;
+        ptr = result.ptr;
+    }
+    return added;
+}
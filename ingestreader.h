@@ -0,0 +1,56 @@
+/******************************************************************************************
+** File: ingestreader.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the IngestReader class.
+** This class fills a BufferList from a file descriptor in large blocks. Text is parsed
+** with std::from_chars and binary input is read, and both land straight in the slots
+** handed out by BufferList::reserve, so no item goes through enqueue one at a time.
+******************************************************************************************/
+
+
+
+#ifndef INGESTREADER_H
+#define INGESTREADER_H
+#include "bufferlist.h"
+#include <cstddef>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const size_t INGEST_BLOCK_BYTES = 1 << 20; // default size of the read block
+const int INGEST_CHUNK = 4096;             // items reserved from the list at a time
+class IngestReader{
+    public:
+    friend class Grader;//Grader will have access to private members of IngestReader
+    friend class Tester;//Tester will have access to private members of IngestReader
+    IngestReader(int fd, size_t blockBytes = INGEST_BLOCK_BYTES);  //reads from a file descriptor
+    ~IngestReader();                //destructor, does not close the file descriptor
+    IngestReader(const IngestReader & rhs) = delete;    //one owner per block
+    IngestReader & operator=(const IngestReader & rhs) = delete;
+    long long readText(BufferList & list);      //enqueues every comma or whitespace separated int, returns how many
+    long long readBinary(BufferList & list);    //enqueues every little endian 32 bit int, returns how many
+    long long bytesRead();          //bytes read from the file descriptor so far
+
+
+    private:
+    char *m_block;          //the read block
+    size_t m_blockBytes;    //size of m_block
+    int m_fd;               //source file descriptor
+    long long m_read;       //bytes read so far
+    BufferReservation m_reservation;    //slots currently being filled
+    int m_span;             //span of m_reservation being filled
+    int m_offset;           //next slot within that span
+    int m_filled;           //slots of m_reservation written so far
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    size_t readSome(char * data, size_t length);    //one read, retried on EINTR, 0 at the end of input
+    void put(BufferList & list, int value);         //writes value into the next reserved slot
+    void finish(BufferList & list);                 //commits the slots written so far
+    long long parseText(BufferList & list, const char * data, size_t length, long long offset); //parses complete tokens
+};
+#endif
@@ -0,0 +1,273 @@
+/******************************************************************************************
+** File: prioritybufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the PriorityBufferList class.
+** Level 0 is the highest priority. Dequeue takes the lowest set bit of the non-empty
+** bitmap, so it costs the same no matter how many levels are empty.
+** Optional weights give weighted round robin: a level with weight w is served at most
+** w times per round while lower levels wait, so low levels are never starved.
+** Levels without a weight are never throttled and do not hold a round open: once an
+** unweighted level has had its turn after every non-empty weighted level has used up
+** its credit, a new round starts.
+******************************************************************************************/
+
+#include "prioritybufferlist.h"
+#include <stdexcept>
+
+/********************************************
+** Function: lowestSetBit(uint64_t bits)
+** Pre-conditions: bits is not 0
+** Post-conditions: Returns the index of the lowest set bit using count trailing zeros
+********************************************/
+static inline int lowestSetBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/********************************************
+** Function: PriorityBufferList(int levels, int minBufCapacity)
+** Pre-conditions: levels is between 1 and MAX_PRIORITY_LEVELS
+** Post-conditions: One empty BufferList is created per level, no level is throttled
+********************************************/
+PriorityBufferList::PriorityBufferList(int levels, int minBufCapacity) {
+    if (levels < 1 || levels > MAX_PRIORITY_LEVELS) {
+        throw std::out_of_range("Number of priority levels must be between 1 and 64!");
+    }
+
+    m_levels = levels;
+    m_minBufCapacity = minBufCapacity;
+    m_nonEmpty = 0;
+    m_weighted = 0;
+    m_lanes = new BufferList*[m_levels];
+    m_weights = new int[m_levels];
+    m_credits = new int[m_levels];
+
+    for (int i = 0; i < m_levels; i++) {
+        m_lanes[i] = new BufferList(minBufCapacity);
+        m_weights[i] = 0;
+        m_credits[i] = 0;
+    }
+    refillCredits();
+}
+
+/********************************************
+** Function: ~PriorityBufferList()
+** Pre-conditions: None
+** Post-conditions: All levels are deallocated
+********************************************/
+PriorityBufferList::~PriorityBufferList() {
+    for (int i = 0; i < m_levels; i++) {
+        delete m_lanes[i];
+    }
+    delete[] m_lanes;
+    delete[] m_weights;
+    delete[] m_credits;
+}
+
+/********************************************
+** Function: copyFrom(const PriorityBufferList& rhs)
+** Pre-conditions: this object owns no memory
+** Post-conditions: This object is a deep copy of rhs
+********************************************/
+void PriorityBufferList::copyFrom(const PriorityBufferList& rhs) {
+    m_levels = rhs.m_levels;
+    m_minBufCapacity = rhs.m_minBufCapacity;
+    m_nonEmpty = rhs.m_nonEmpty;
+    m_eligible = rhs.m_eligible;
+    m_weighted = rhs.m_weighted;
+    m_lanes = new BufferList*[m_levels];
+    m_weights = new int[m_levels];
+    m_credits = new int[m_levels];
+
+    for (int i = 0; i < m_levels; i++) {
+        m_lanes[i] = new BufferList(*rhs.m_lanes[i]);
+        m_weights[i] = rhs.m_weights[i];
+        m_credits[i] = rhs.m_credits[i];
+    }
+}
+
+/********************************************
+** Function: PriorityBufferList(const PriorityBufferList& rhs)
+** Pre-conditions: rhs is a PriorityBufferList object to be copied
+** Post-conditions: A new PriorityBufferList object is created as a copy of rhs
+********************************************/
+PriorityBufferList::PriorityBufferList(const PriorityBufferList& rhs) {
+    copyFrom(rhs);
+}
+
+/********************************************
+** Function: operator=(const PriorityBufferList& rhs)
+** Pre-conditions: rhs is a PriorityBufferList object to be assigned
+** Post-conditions: The current object is assigned the values of rhs
+********************************************/
+const PriorityBufferList& PriorityBufferList::operator=(const PriorityBufferList& rhs) {
+    if (this == &rhs) return *this; // Self-assignment check
+
+    for (int i = 0; i < m_levels; i++) {
+        delete m_lanes[i];
+    }
+    delete[] m_lanes;
+    delete[] m_weights;
+    delete[] m_credits;
+
+    copyFrom(rhs);
+    return *this;
+}
+
+/********************************************
+** Function: refillCredits()
+** Pre-conditions: None
+** Post-conditions: Every level gets its full weight of credit for a new round
+********************************************/
+void PriorityBufferList::refillCredits() {
+    m_eligible = 0;
+    for (int i = 0; i < m_levels; i++) {
+        m_credits[i] = m_weights[i];
+        m_eligible |= (uint64_t(1) << i);
+    }
+}
+
+/********************************************
+** Function: setWeight(int level, int weight)
+** Pre-conditions: level is a valid level, weight is 0 or larger
+** Post-conditions: The level is served at most weight times per fairness round,
+** a weight of 0 turns throttling off for that level
+********************************************/
+void PriorityBufferList::setWeight(int level, int weight) {
+    if (level < 0 || level >= m_levels) {
+        throw std::out_of_range("Priority level out of range!");
+    }
+    m_weights[level] = weight < 0 ? 0 : weight;
+    if (m_weights[level] > 0) {
+        m_weighted |= (uint64_t(1) << level);
+    }
+    else {
+        m_weighted &= ~(uint64_t(1) << level);
+    }
+    refillCredits();
+}
+
+/********************************************
+** Function: enqueue(int level, const int& data)
+** Pre-conditions: level is a valid level
+** Post-conditions: data is added to the level and the level is marked non-empty
+********************************************/
+void PriorityBufferList::enqueue(int level, const int& data) {
+    if (level < 0 || level >= m_levels) {
+        throw std::out_of_range("Priority level out of range!");
+    }
+    m_lanes[level]->enqueue(data);
+    m_nonEmpty |= (uint64_t(1) << level);
+}
+
+/********************************************
+** Function: dequeue(int& level)
+** Pre-conditions: None
+** Post-conditions: The oldest item of the highest priority level that still has credit
+** is removed and returned, level is set to where it came from. A new round starts when
+** no non-empty level has credit left, or when an unweighted level was served and no
+** non-empty weighted level has credit left.
+** Throws underflow_error if every level is empty.
+********************************************/
+int PriorityBufferList::dequeue(int& level) {
+    if (m_nonEmpty == 0) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+
+    uint64_t ready = m_nonEmpty & m_eligible;
+    if (ready == 0) {
+        // every non-empty level used up its credit, start a new round
+        refillCredits();
+        ready = m_nonEmpty;
+    }
+
+    level = lowestSetBit(ready);
+    int data = m_lanes[level]->dequeue();
+
+    if (m_lanes[level]->empty()) {
+        m_nonEmpty &= ~(uint64_t(1) << level);
+    }
+    if (m_weights[level] > 0) {
+        if (--m_credits[level] == 0) {
+            m_eligible &= ~(uint64_t(1) << level);
+        }
+    }
+    else {
+        // an unweighted level never runs out of credit, so it ends the round itself
+        // once the weighted levels waiting on it have none left
+        uint64_t weighted = m_nonEmpty & m_weighted;
+        if (weighted != 0 && (weighted & m_eligible) == 0) {
+            refillCredits();
+        }
+    }
+    return data;
+}
+
+/********************************************
+** Function: dequeue()
+** Pre-conditions: None
+** Post-conditions: Same as dequeue(int& level) without reporting the level
+********************************************/
+int PriorityBufferList::dequeue() {
+    int level;
+    return dequeue(level);
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if no level holds an item
+********************************************/
+bool PriorityBufferList::empty() {
+    return m_nonEmpty == 0;
+}
+
+/********************************************
+** Function: levels()
+** Pre-conditions: None
+** Post-conditions: Returns the number of priority levels
+********************************************/
+int PriorityBufferList::levels() {
+    return m_levels;
+}
+
+/********************************************
+** Function: clear()
+** Pre-conditions: None
+** Post-conditions: Every level is emptied, the levels stay usable
+********************************************/
+void PriorityBufferList::clear() {
+    for (int i = 0; i < m_levels; i++) {
+        delete m_lanes[i];
+        m_lanes[i] = new BufferList(m_minBufCapacity);
+    }
+    m_nonEmpty = 0;
+    refillCredits();
+}
+
+/********************************************
+** Function: dump()
+** Pre-conditions: None
+** Post-conditions: The contents of every non-empty level are printed to the console
+********************************************/
+void PriorityBufferList::dump() {
+    for (int i = 0; i < m_levels; i++) {
+        if (m_nonEmpty & (uint64_t(1) << i)) {
+            cout << "Level " << i << ":" << endl;
+            m_lanes[i]->dump();
+        }
+    }
+}
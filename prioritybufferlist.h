@@ -0,0 +1,58 @@
+/******************************************************************************************
+** File: prioritybufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the PriorityBufferList class.
+** This class is a priority queue of FIFOs. Every priority level is its own BufferList
+** and a bitmap records which levels are non-empty, so the highest priority item is
+** found with a single count-trailing-zeros instruction instead of polling each level.
+******************************************************************************************/
+
+
+
+#ifndef PRIORITYBUFFERLIST_H
+#define PRIORITYBUFFERLIST_H
+#include "bufferlist.h"
+#include <cstdint>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const int MAX_PRIORITY_LEVELS = 64;  // one bit per level in the non-empty bitmap
+class PriorityBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of PriorityBufferList
+    friend class Tester;//Tester will have access to private members of PriorityBufferList
+    PriorityBufferList(int levels, int minBufCapacity); //constructor, level 0 is the highest priority
+    ~PriorityBufferList();                              //destructor
+    PriorityBufferList(const PriorityBufferList & rhs); //copy constructor
+    const PriorityBufferList & operator=(const PriorityBufferList & rhs);// overloaded assignment operator
+    void enqueue(int level, const int & data);  //add data to the given priority level
+    int dequeue();                      //remove the oldest item of the highest non-empty level
+    int dequeue(int & level);           //same as dequeue, also reports the level it came from
+    void setWeight(int level, int weight);  //max items served from level per fairness round, 0 = unlimited
+    bool empty();                       //returns true if every level is empty
+    int levels();                       //returns the number of priority levels
+    void clear();                       //clear all data, deallocate all memory
+    void dump();                        //prints out the contents, for debugging purposes
+
+
+    private:
+    BufferList ** m_lanes;  //one BufferList per priority level
+    int * m_weights;        //fairness weight per level, 0 means the level is never throttled
+    int * m_credits;        //items a level may still dequeue in the current fairness round
+    uint64_t m_nonEmpty;    //bit i is set when level i holds at least one item
+    uint64_t m_eligible;    //bit i is set when level i still has credit in this round
+    uint64_t m_weighted;    //bit i is set when level i has a weight, the round only waits for these
+    int m_levels;           //number of priority levels
+    int m_minBufCapacity;   //the min size for circular buffers in each level
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void copyFrom(const PriorityBufferList & rhs);  //deep copies rhs into this empty object
+    void refillCredits();                           //starts a new fairness round
+};
+#endif
@@ -0,0 +1,177 @@
+/******************************************************************************************
+** File: segmentarena.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the SegmentArena class.
+** Allocations are bump-allocated from the newest chunk. Requests larger than a chunk
+** get a chunk of their own. Deallocation never goes upstream, the block is put on the
+** free list for its rounded size, so steady enqueue/dequeue traffic reuses segments.
+******************************************************************************************/
+
+#include "segmentarena.h"
+#include <cstdint>
+
+const size_t ARENA_GRANULE = alignof(std::max_align_t); // every block is a multiple of this
+
+/********************************************
+** Function: roundUp(size_t value, size_t alignment)
+** Pre-conditions: alignment is a power of two
+** Post-conditions: Returns value rounded up to a multiple of alignment
+********************************************/
+static inline size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/********************************************
+** Function: SegmentArena(size_t chunkBytes, std::pmr::memory_resource* upstream)
+** Pre-conditions: upstream is not nullptr
+** Post-conditions: An empty arena is created, no memory is taken from upstream yet
+********************************************/
+SegmentArena::SegmentArena(size_t chunkBytes, std::pmr::memory_resource* upstream) {
+    m_upstream = upstream;
+    m_chunkBytes = (chunkBytes < 1024) ? 1024 : chunkBytes;
+    m_chunks = nullptr;
+    m_current = nullptr;
+    m_limit = nullptr;
+    m_bytesReserved = 0;
+    m_users = 0;
+}
+
+/********************************************
+** Function: ~SegmentArena()
+** Pre-conditions: None
+** Post-conditions: Every chunk is returned to upstream
+********************************************/
+SegmentArena::~SegmentArena() {
+    release();
+}
+
+/********************************************
+** Function: release()
+** Pre-conditions: None
+** Post-conditions: Every chunk is returned to upstream and every block handed out
+** by this arena becomes invalid. Costs one upstream call per chunk, not per block.
+********************************************/
+void SegmentArena::release() {
+    while (m_chunks != nullptr) {
+        Chunk* next = m_chunks->next;
+        m_upstream->deallocate(m_chunks, m_chunks->bytes, m_chunks->align);
+        m_chunks = next;
+    }
+    m_freeLists.clear();
+    m_current = nullptr;
+    m_limit = nullptr;
+    m_bytesReserved = 0;
+}
+
+/********************************************
+** Function: attach(), detach(), users()
+** Pre-conditions: None
+** Post-conditions: Count the BufferLists using this arena, a BufferList only
+** releases the arena on clear when it is the only user
+********************************************/
+void SegmentArena::attach() {
+    m_users++;
+}
+
+void SegmentArena::detach() {
+    m_users--;
+}
+
+int SegmentArena::users() {
+    return m_users;
+}
+
+/********************************************
+** Function: bytesReserved()
+** Pre-conditions: None
+** Post-conditions: Returns the number of bytes held from upstream
+********************************************/
+size_t SegmentArena::bytesReserved() {
+    return m_bytesReserved;
+}
+
+/********************************************
+** Function: newChunk(size_t bytes, size_t alignment)
+** Pre-conditions: bytes is the size of the block that did not fit
+** Post-conditions: A chunk large enough for the block is taken from upstream and linked
+** into m_chunks. Returns the first usable byte after the chunk header.
+********************************************/
+void* SegmentArena::newChunk(size_t bytes, size_t alignment) {
+    size_t header = roundUp(sizeof(Chunk), alignment);
+    size_t size = header + bytes;
+    if (size < m_chunkBytes) {
+        size = m_chunkBytes;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignment));
+    chunk->next = m_chunks;
+    chunk->bytes = size;
+    chunk->align = alignment;
+    m_chunks = chunk;
+    m_bytesReserved += size;
+
+    char* first = reinterpret_cast<char*>(chunk) + header;
+    if (size - header - bytes >= ARENA_GRANULE) {
+        // the rest of the chunk becomes the new bump region
+        m_current = first + bytes;
+        m_limit = reinterpret_cast<char*>(chunk) + size;
+    }
+    return first;
+}
+
+/********************************************
+** Function: do_allocate(size_t bytes, size_t alignment)
+** Pre-conditions: alignment is a power of two
+** Post-conditions: Returns a block of at least bytes, reusing a freed block of the same
+** rounded size when one is available and suitably aligned
+********************************************/
+void* SegmentArena::do_allocate(size_t bytes, size_t alignment) {
+    if (alignment < ARENA_GRANULE) {
+        alignment = ARENA_GRANULE;
+    }
+    size_t rounded = roundUp(bytes == 0 ? 1 : bytes, ARENA_GRANULE);
+
+    std::unordered_map<size_t, FreeBlock*>::iterator it = m_freeLists.find(rounded);
+    if (it != m_freeLists.end() && it->second != nullptr
+        && reinterpret_cast<uintptr_t>(it->second) % alignment == 0) {
+        FreeBlock* block = it->second;
+        it->second = block->next;
+        return block;
+    }
+
+    if (m_current != nullptr) {
+        char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(m_current), alignment));
+        if (aligned + rounded <= m_limit) {
+            m_current = aligned + rounded;
+            return aligned;
+        }
+    }
+    return newChunk(rounded, alignment);
+}
+
+/********************************************
+** Function: do_deallocate(void* p, size_t bytes, size_t alignment)
+** Pre-conditions: p was returned by this arena for the same bytes
+** Post-conditions: The block is kept on the free list for its rounded size
+********************************************/
+void SegmentArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    (void)alignment;
+    size_t rounded = roundUp(bytes == 0 ? 1 : bytes, ARENA_GRANULE);
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = m_freeLists[rounded];
+    m_freeLists[rounded] = block;
+}
+
+/********************************************
+** Function: do_is_equal(const std::pmr::memory_resource& other)
+** Pre-conditions: None
+** Post-conditions: Returns true only for the same arena
+********************************************/
+bool SegmentArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,68 @@
+/******************************************************************************************
+** File: segmentarena.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the SegmentArena class.
+** This class is a std::pmr::memory_resource that carves Buffer headers and storage out
+** of large chunks. Freed blocks are kept on per-size free lists and handed out again,
+** and release() returns every chunk at once. A BufferList that is the only user of an
+** arena clears itself by releasing the arena instead of deleting buffer by buffer.
+******************************************************************************************/
+
+
+
+#ifndef SEGMENTARENA_H
+#define SEGMENTARENA_H
+#include <memory_resource>
+#include <unordered_map>
+#include <cstddef>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const size_t DEFAULT_ARENA_CHUNK = 64 * 1024;   // bytes requested from upstream per chunk
+class SegmentArena : public std::pmr::memory_resource{
+    public:
+    friend class Grader;//Grader will have access to private members of SegmentArena
+    friend class Tester;//Tester will have access to private members of SegmentArena
+    SegmentArena(size_t chunkBytes = DEFAULT_ARENA_CHUNK,
+                 std::pmr::memory_resource * upstream = std::pmr::get_default_resource()); //constructor
+    ~SegmentArena();                            //destructor, releases all chunks
+    SegmentArena(const SegmentArena & rhs) = delete;            //an arena owns its chunks
+    SegmentArena & operator=(const SegmentArena & rhs) = delete;
+    void release();         //returns every chunk to upstream, all blocks become invalid
+    void attach();          //a BufferList starts using this arena
+    void detach();          //a BufferList stops using this arena
+    int users();            //number of BufferLists using this arena
+    size_t bytesReserved(); //bytes currently held from upstream
+
+
+    private:
+    struct Chunk{
+        Chunk *next;        // previously allocated chunk
+        size_t bytes;       // size of the chunk including this header
+        size_t align;       // alignment the chunk was requested with
+    };
+    struct FreeBlock{
+        FreeBlock *next;    // next free block of the same size
+    };
+    std::pmr::memory_resource *m_upstream;  // where chunks come from
+    size_t m_chunkBytes;    // default chunk size
+    Chunk *m_chunks;        // every chunk allocated so far
+    char *m_current;        // next free byte of the newest chunk
+    char *m_limit;          // end of the newest chunk
+    size_t m_bytesReserved; // bytes held from upstream
+    int m_users;            // BufferLists attached to this arena
+    std::unordered_map<size_t, FreeBlock*> m_freeLists; // freed blocks by rounded size
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+    void* newChunk(size_t bytes, size_t alignment);     //gets a chunk from upstream
+};
+#endif
@@ -0,0 +1,210 @@
+/******************************************************************************************
+** File: shardedbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the ShardedBufferList class.
+** Thread shards are handed out round robin the first time a thread asks. A steal
+** locks the victim and the home shard together and moves whole buffers with
+** transferFront, so a thief comes back to the victim at most once per half.
+******************************************************************************************/
+
+#include "shardedbufferlist.h"
+#include <stdexcept>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static std::atomic<unsigned> nextThreadToken(0);   // hands out thread shard tokens
+static thread_local unsigned threadToken = nextThreadToken.fetch_add(1);
+
+/********************************************
+** Function: ShardedBufferList(int shards, int minBufCapacity)
+** Pre-conditions: minBufCapacity is an integer larger than 0
+** Post-conditions: shards empty shards are created. Throws std::out_of_range if
+** shards is less than 1.
+********************************************/
+ShardedBufferList::ShardedBufferList(int shards, int minBufCapacity) {
+    if (shards < 1) {
+        throw std::out_of_range("ShardedBufferList needs at least one shard");
+    }
+    m_shardCount = shards;
+    m_shards = new Shard[shards];
+    for (int i = 0; i < shards; i++) {
+        m_shards[i].list = new BufferList(minBufCapacity);
+        m_shards[i].count = 0;
+    }
+    m_cpuShards = false;
+    m_steals = 0;
+}
+
+/********************************************
+** Function: ~ShardedBufferList()
+** Pre-conditions: No other thread uses the object
+** Post-conditions: Every shard is deallocated
+********************************************/
+ShardedBufferList::~ShardedBufferList() {
+    for (int i = 0; i < m_shardCount; i++) {
+        delete m_shards[i].list;
+    }
+    delete[] m_shards;
+}
+
+/********************************************
+** Function: enqueue(const int& data)
+** Pre-conditions: None
+** Post-conditions: data is added to the back of the calling thread's home shard
+********************************************/
+void ShardedBufferList::enqueue(const int& data) {
+    enqueue(homeShard(), data);
+}
+
+/********************************************
+** Function: enqueue(int shard, const int& data)
+** Pre-conditions: None
+** Post-conditions: data is added to the back of shard. Throws std::out_of_range if
+** shard does not exist.
+********************************************/
+void ShardedBufferList::enqueue(int shard, const int& data) {
+    if (shard < 0 || shard >= m_shardCount) {
+        throw std::out_of_range("Shard does not exist");
+    }
+    Shard & target = m_shards[shard];
+    std::lock_guard<std::mutex> lock(target.mutex);
+    target.list->enqueue(data);
+    target.count.store(target.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/********************************************
+** Function: tryDequeue(int& data)
+** Pre-conditions: None
+** Post-conditions: See tryDequeue(int, int&), with the calling thread's home shard
+********************************************/
+bool ShardedBufferList::tryDequeue(int& data) {
+    return tryDequeue(homeShard(), data);
+}
+
+/********************************************
+** Function: tryDequeue(int shard, int& data)
+** Pre-conditions: None
+** Post-conditions: Stores the oldest item of shard in data, or if shard is empty steals
+** from the next non-empty shard. Returns false if every shard looked empty. Throws
+** std::out_of_range if shard does not exist.
+********************************************/
+bool ShardedBufferList::tryDequeue(int shard, int& data) {
+    if (shard < 0 || shard >= m_shardCount) {
+        throw std::out_of_range("Shard does not exist");
+    }
+    Shard & home = m_shards[shard];
+    if (home.count.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(home.mutex);
+        if (!home.list->empty()) {
+            data = home.list->dequeue();
+            home.count.store(home.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return steal(shard, data);
+}
+
+/********************************************
+** Function: useCpuShards(bool enabled)
+** Pre-conditions: None
+** Post-conditions: With enabled, homeShard is the current CPU modulo the number of
+** shards, where the system reports it. Otherwise every thread keeps its own shard.
+********************************************/
+void ShardedBufferList::useCpuShards(bool enabled) {
+    m_cpuShards = enabled;
+}
+
+/********************************************
+** Function: homeShard()
+** Pre-conditions: None
+** Post-conditions: Returns the shard the calling thread enqueues into and dequeues from
+********************************************/
+int ShardedBufferList::homeShard() {
+#ifdef __linux__
+    if (m_cpuShards) {
+        int cpu = sched_getcpu();
+        if (cpu >= 0) return cpu % m_shardCount;
+    }
+#endif
+    return (int)(threadToken % (unsigned)m_shardCount);
+}
+
+/********************************************
+** Function: shards()
+** Pre-conditions: None
+** Post-conditions: Returns the number of shards
+********************************************/
+int ShardedBufferList::shards() {
+    return m_shardCount;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items over all shards. Shards are read one by
+** one, so the result is approximate while other threads use the list.
+********************************************/
+int ShardedBufferList::count() {
+    int total = 0;
+    for (int i = 0; i < m_shardCount; i++) {
+        total += m_shards[i].count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/********************************************
+** Function: steals()
+** Pre-conditions: None
+** Post-conditions: Returns the number of successful steals so far
+********************************************/
+unsigned long long ShardedBufferList::steals() {
+    return m_steals.load(std::memory_order_relaxed);
+}
+
+/********************************************
+** Function: clear()
+** Pre-conditions: None
+** Post-conditions: Every shard is emptied one by one
+********************************************/
+void ShardedBufferList::clear() {
+    for (int i = 0; i < m_shardCount; i++) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].list->consume(m_shards[i].list->count());
+        m_shards[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+/********************************************
+** Function: steal(int home, int& data)
+** Pre-conditions: home is a valid shard
+** Post-conditions: Looks at the other shards starting after home. The first non-empty
+** one gives its older half (at least one item) to home, oldest first, and the oldest of
+** those is stored in data. Returns false if no shard had an item.
+********************************************/
+bool ShardedBufferList::steal(int home, int& data) {
+    for (int step = 1; step < m_shardCount; step++) {
+        Shard & victim = m_shards[(home + step) % m_shardCount];
+        if (victim.count.load(std::memory_order_relaxed) == 0) continue;
+
+        Shard & thief = m_shards[home];
+        std::scoped_lock lock(victim.mutex, thief.mutex);
+        int available = victim.list->count();
+        if (available == 0) continue;
+
+        // home may have been refilled meanwhile, its own items stay in front
+        int moved = victim.list->transferFront(*thief.list, (available + 1) / 2);
+        victim.count.store(available - moved, std::memory_order_relaxed);
+        data = thief.list->dequeue();
+        thief.count.store(thief.list->count(), std::memory_order_relaxed);
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************************
+** File: shardedbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the ShardedBufferList class.
+** This class spreads items over independent BufferList shards, each with its own lock
+** on its own cache lines, so producers on different cores do not fight over one list.
+** A thread enqueues into its home shard, picked by thread or by CPU, and dequeues from
+** it first. When the home shard is empty it steals half of another shard.
+**
+** Ordering is relaxed: items of one shard come out in FIFO order, and items stolen
+** from a shard keep their order, but there is no order between shards. Items from one
+** producer thread stay FIFO as long as it keeps its home shard, which is always true
+** for thread shards and true for CPU shards while the thread is not migrated.
+******************************************************************************************/
+
+
+
+#ifndef SHARDEDBUFFERLIST_H
+#define SHARDEDBUFFERLIST_H
+#include "bufferlist.h"
+#include <mutex>
+#include <atomic>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+class ShardedBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of ShardedBufferList
+    friend class Tester;//Tester will have access to private members of ShardedBufferList
+    ShardedBufferList(int shards, int minBufCapacity);  //constructor, shards is 1 or larger
+    ~ShardedBufferList();                               //destructor
+    ShardedBufferList(const ShardedBufferList & rhs) = delete;  //the shards hold locks
+    ShardedBufferList & operator=(const ShardedBufferList & rhs) = delete;
+    void enqueue(const int & data);             //add data to the calling thread's home shard
+    void enqueue(int shard, const int & data);  //add data to the given shard
+    bool tryDequeue(int & data);                //takes an item from the home shard, else steals
+    bool tryDequeue(int shard, int & data);     //same, with shard as the home shard
+    void useCpuShards(bool enabled);            //pick the home shard by CPU instead of by thread
+    int homeShard();                            //shard the calling thread uses
+    int shards();                               //number of shards
+    int count();                                //number of items over all shards, approximate while in use
+    unsigned long long steals();                //number of successful steals so far
+    void clear();                               //removes every item
+
+
+    private:
+    struct alignas(CACHE_LINE_SIZE) Shard{
+        std::mutex mutex;           // guards list
+        BufferList *list;           // the items of this shard
+        std::atomic<int> count;     // items in list, read without the lock to skip empty shards
+    };
+    Shard *m_shards;            //the shards, each on its own cache lines
+    int m_shardCount;           //number of shards
+    bool m_cpuShards;           //whether homeShard uses the CPU id
+    std::atomic<unsigned long long> m_steals;   //successful steals
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    bool steal(int home, int & data);   //moves half of a non-empty shard into home and takes one item
+};
+#endif
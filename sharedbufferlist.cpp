@@ -0,0 +1,509 @@
+/******************************************************************************************
+** File: sharedbufferlist.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the SharedBufferList class.
+** The region is the header, then the free ring, then the buffers, each part starting
+** on a cache line. Buffers are filled once from the start and never wrap: the producer
+** publishes a buffer's items by storing its end with release order, and links the next
+** buffer only after its items are published, so a consumer that finds a drained buffer
+** with a next link knows the producer is done with it and can hand it back.
+******************************************************************************************/
+
+#include "sharedbufferlist.h"
+#include <stdexcept>
+#include <system_error>
+#include <new>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "region counters must be lock free to work across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "region counters must be lock free to work across processes");
+
+/********************************************
+** Function: shmName(const std::string& name)
+** Pre-conditions: None
+** Post-conditions: Returns name with the leading slash shm_open expects
+********************************************/
+static std::string shmName(const std::string& name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+/********************************************
+** Function: roundUp(size_t bytes)
+** Pre-conditions: None
+** Post-conditions: Returns bytes rounded up to a whole number of cache lines
+********************************************/
+static size_t roundUp(size_t bytes) {
+    return (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+/********************************************
+** Function: SharedBufferList(const std::string& name, int bufferCapacity, int buffers)
+** Pre-conditions: No region called name exists
+** Post-conditions: The region name is created and mapped, with buffers empty buffers of
+** bufferCapacity items; the first is the head and the tail, the others are free. Throws
+** invalid_argument unless bufferCapacity is 1 or larger and buffers is 2 or larger, and
+** std::system_error if the region cannot be created.
+********************************************/
+SharedBufferList::SharedBufferList(const std::string& name, int bufferCapacity, int buffers) {
+    if (bufferCapacity < 1 || buffers < 2) {
+        // with one buffer the producer could never move on from a full, drained tail
+        throw std::invalid_argument("A shared list needs a capacity of 1 or more and 2 or more buffers");
+    }
+
+    size_t segmentBytes = roundUp(sizeof(Segment) + (size_t)bufferCapacity * sizeof(int));
+    size_t ringOffset = roundUp(sizeof(Header));
+    size_t firstSegment = ringOffset + roundUp((size_t)buffers * sizeof(uint64_t));
+    size_t size = firstSegment + (size_t)buffers * segmentBytes;
+
+    std::string path = shmName(name);
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + path);
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        int error = errno;
+        close(fd);
+        shm_unlink(path.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + path);
+    }
+    try {
+        map(fd, size);
+    }
+    catch (...) {
+        shm_unlink(path.c_str());
+        throw;
+    }
+
+    m_header = new (m_base) Header;
+    m_header->capacity = (uint32_t)bufferCapacity;
+    m_header->bufferCount = (uint32_t)buffers;
+    m_header->segmentBytes = segmentBytes;
+    m_header->regionBytes = size;
+    m_header->ringOffset = ringOffset;
+
+    uint64_t* ring = (uint64_t*)(m_base + ringOffset);
+    for (int i = 0; i < buffers; i++) {
+        uint64_t offset = firstSegment + (uint64_t)i * segmentBytes;
+        Segment* segment = new (m_base + offset) Segment;
+        segment->next.store(0, std::memory_order_relaxed);
+        segment->end.store(0, std::memory_order_relaxed);
+        segment->start = 0;
+        if (i > 0) {
+            ring[i - 1] = offset;
+        }
+    }
+
+    m_header->tail = firstSegment;
+    m_header->spare = 0;
+    m_header->produced.store(0, std::memory_order_relaxed);
+    m_header->freeRead = 0;
+    m_header->head = firstSegment;
+    m_header->consumed.store(0, std::memory_order_relaxed);
+    m_header->freeWrite.store((uint64_t)buffers - 1, std::memory_order_relaxed);
+
+    // an opener only trusts the region once the magic is there
+    m_header->magic.store(SHARED_MAGIC, std::memory_order_release);
+}
+
+/********************************************
+** Function: SharedBufferList(const std::string& name)
+** Pre-conditions: None
+** Post-conditions: The existing region name is mapped. Throws std::system_error if it
+** cannot be opened and runtime_error if it is not a fully created SharedBufferList.
+********************************************/
+SharedBufferList::SharedBufferList(const std::string& name) {
+    std::string path = shmName(name);
+    int fd = shm_open(path.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    if ((size_t)info.st_size < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error(path + " is not a SharedBufferList region");
+    }
+    map(fd, (size_t)info.st_size);
+
+    m_header = (Header*)m_base;
+    if (m_header->magic.load(std::memory_order_acquire) != SHARED_MAGIC
+        || m_header->regionBytes != m_size) {
+        munmap(m_base, m_size);
+        throw std::runtime_error(path + " is not a SharedBufferList region");
+    }
+}
+
+/********************************************
+** Function: ~SharedBufferList()
+** Pre-conditions: None
+** Post-conditions: The region is unmapped from this process. It and its items stay
+** for other processes until remove is called and the last of them unmaps it.
+********************************************/
+SharedBufferList::~SharedBufferList() {
+    munmap(m_base, m_size);
+}
+
+/********************************************
+** Function: remove(const std::string& name)
+** Pre-conditions: None
+** Post-conditions: The name is deleted so no new process can open the region; existing
+** mappings keep working. A missing name is ignored.
+********************************************/
+void SharedBufferList::remove(const std::string& name) {
+    shm_unlink(shmName(name).c_str());
+}
+
+/********************************************
+** Function: reserve(int n)
+** Pre-conditions: Only the producer calls it
+** Post-conditions: Returns writable region slots for up to n new items: the free space
+** of the tail, then the start of a free buffer if that is not enough. Fewer than n, or
+** none, are handed out when the free buffers run out. Nothing is visible to the
+** consumer until commit. A second reserve replaces the first.
+********************************************/
+BufferReservation SharedBufferList::reserve(int n) {
+    BufferReservation reservation;
+    reservation.spanCount = 0;
+    reservation.total = 0;
+    m_reservedCount = 0;
+    if (n <= 0) return reservation;
+
+    int capacity = (int)m_header->capacity;
+    Segment* tail = segmentAt(m_header->tail);
+    int end = (int)tail->end.load(std::memory_order_relaxed);
+    int inTail = (n < capacity - end) ? n : capacity - end;
+    if (inTail > 0) {
+        reservation.spans[reservation.spanCount++] = {itemsOf(tail) + end, inTail};
+        reservation.total += inTail;
+    }
+
+    int rest = n - inTail;
+    if (rest > 0) {
+        if (m_header->spare == 0) {
+            m_header->spare = takeFree();
+        }
+        if (m_header->spare != 0) {
+            int inSpare = (rest < capacity) ? rest : capacity;
+            reservation.spans[reservation.spanCount++] = {itemsOf(segmentAt(m_header->spare)), inSpare};
+            reservation.total += inSpare;
+        }
+    }
+
+    m_reservedCount = reservation.total;
+    return reservation;
+}
+
+/********************************************
+** Function: commit(int k)
+** Pre-conditions: reserve was called and the first k slots were written
+** Post-conditions: The first k reserved items are published to the consumer. If they
+** reach into the spare buffer, its end is set, the tail is published as full and then
+** linked to it, and it becomes the tail. Throws out_of_range if k is larger than the
+** reservation.
+********************************************/
+void SharedBufferList::commit(int k) {
+    if (k < 0 || k > m_reservedCount) {
+        throw std::out_of_range("Commit is larger than the reservation!");
+    }
+
+    int capacity = (int)m_header->capacity;
+    Segment* tail = segmentAt(m_header->tail);
+    int end = (int)tail->end.load(std::memory_order_relaxed);
+    int inTail = (k < capacity - end) ? k : capacity - end;
+
+    if (k > inTail) {
+        Segment* spare = segmentAt(m_header->spare);
+        spare->end.store((uint32_t)(k - inTail), std::memory_order_relaxed);
+        tail->end.store((uint32_t)capacity, std::memory_order_release);
+        tail->next.store(m_header->spare, std::memory_order_release);
+        m_header->tail = m_header->spare;
+        m_header->spare = 0;
+    }
+    else if (inTail > 0) {
+        tail->end.store((uint32_t)(end + inTail), std::memory_order_release);
+    }
+
+    m_header->produced.store(m_header->produced.load(std::memory_order_relaxed) + k, std::memory_order_release);
+    m_reservedCount = 0;
+}
+
+/********************************************
+** Function: tryEnqueue(const int& data)
+** Pre-conditions: Only the producer calls it
+** Post-conditions: data is published and true is returned, or false if there was no
+** room because the consumer has not drained enough buffers
+********************************************/
+bool SharedBufferList::tryEnqueue(const int& data) {
+    BufferReservation reservation = reserve(1);
+    if (reservation.total == 0) return false;
+    reservation.spans[0].data[0] = data;
+    commit(1);
+    return true;
+}
+
+/********************************************
+** Function: enqueueBatch(const int* data, int n)
+** Pre-conditions: Only the producer calls it, data holds n items
+** Post-conditions: As many of data's items as there is room for are published in
+** order, and that number is returned
+********************************************/
+int SharedBufferList::enqueueBatch(const int* data, int n) {
+    int added = 0;
+    while (added < n) {
+        BufferReservation reservation = reserve(n - added);
+        if (reservation.total == 0) break;
+        int written = 0;
+        for (int s = 0; s < reservation.spanCount; s++) {
+            memcpy(reservation.spans[s].data, data + added + written, reservation.spans[s].length * sizeof(int));
+            written += reservation.spans[s].length;
+        }
+        commit(written);
+        added += written;
+    }
+    return added;
+}
+
+/********************************************
+** Function: peekBatch(int n)
+** Pre-conditions: Only the consumer calls it
+** Post-conditions: Returns a view of up to n oldest published items as spans into the
+** region, oldest first, at most one span per buffer and MAX_VIEW_SPANS in all. The
+** spans stay valid until consume passes them.
+********************************************/
+BufferView SharedBufferList::peekBatch(int n) {
+    BufferView view;
+    view.spanCount = 0;
+    view.total = 0;
+
+    uint32_t capacity = m_header->capacity;
+    Segment* segment = segmentAt(m_header->head);
+    while (view.total < n && view.spanCount < MAX_VIEW_SPANS) {
+        uint32_t end = segment->end.load(std::memory_order_acquire);
+        int available = (int)(end - segment->start);
+        if (available > 0) {
+            int length = (available < n - view.total) ? available : n - view.total;
+            view.spans[view.spanCount++] = {itemsOf(segment) + segment->start, length};
+            view.total += length;
+        }
+        if (end < capacity) break;  // the producer is still filling it
+
+        uint64_t next = segment->next.load(std::memory_order_acquire);
+        if (next == 0) break;
+        segment = segmentAt(next);
+    }
+    return view;
+}
+
+/********************************************
+** Function: consume(int k)
+** Pre-conditions: Only the consumer calls it, k is 0 or larger
+** Post-conditions: Up to k oldest published items are removed, and buffers drained on
+** the way are handed back to the producer. Returns the number of items removed.
+********************************************/
+int SharedBufferList::consume(int k) {
+    uint32_t capacity = m_header->capacity;
+    int removed = 0;
+    while (removed < k) {
+        Segment* head = segmentAt(m_header->head);
+        if (head->start == capacity) {
+            if (!advanceHead()) break;
+            continue;
+        }
+        int available = (int)(head->end.load(std::memory_order_acquire) - head->start);
+        int taken = (available < k - removed) ? available : k - removed;
+        if (taken == 0) break;
+        head->start += (uint32_t)taken;
+        removed += taken;
+    }
+
+    // a drained head goes back to the producer as soon as it can
+    if (segmentAt(m_header->head)->start == capacity) {
+        advanceHead();
+    }
+    m_header->consumed.store(m_header->consumed.load(std::memory_order_relaxed) + removed, std::memory_order_release);
+    return removed;
+}
+
+/********************************************
+** Function: tryDequeue(int& data)
+** Pre-conditions: Only the consumer calls it
+** Post-conditions: The oldest item is removed into data and true is returned, or false
+** if nothing is published
+********************************************/
+bool SharedBufferList::tryDequeue(int& data) {
+    BufferView view = peekBatch(1);
+    if (view.total == 0) return false;
+    data = view.spans[0].data[0];
+    consume(1);
+    return true;
+}
+
+/********************************************
+** Function: dequeueBatch(int* out, int n)
+** Pre-conditions: Only the consumer calls it, out has room for n items
+** Post-conditions: Up to n oldest items are copied to out and removed, and the number
+** moved is returned
+********************************************/
+int SharedBufferList::dequeueBatch(int* out, int n) {
+    int moved = 0;
+    while (moved < n) {
+        BufferView view = peekBatch(n - moved);
+        if (view.total == 0) break;
+        for (int s = 0; s < view.spanCount; s++) {
+            memcpy(out + moved, view.spans[s].data, view.spans[s].length * sizeof(int));
+            moved += view.spans[s].length;
+        }
+        consume(view.total);
+    }
+    return moved;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the items published and not yet consumed, which may already
+** be stale while the other process runs
+********************************************/
+int SharedBufferList::count() {
+    uint64_t consumed = m_header->consumed.load(std::memory_order_acquire);
+    uint64_t produced = m_header->produced.load(std::memory_order_acquire);
+    return (produced > consumed) ? (int)(produced - consumed) : 0;
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if nothing is published and not consumed
+********************************************/
+bool SharedBufferList::empty() {
+    return count() == 0;
+}
+
+/********************************************
+** Function: bufferCapacity()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items per buffer
+********************************************/
+int SharedBufferList::bufferCapacity() {
+    return (int)m_header->capacity;
+}
+
+/********************************************
+** Function: buffers()
+** Pre-conditions: None
+** Post-conditions: Returns the number of buffers in the region
+********************************************/
+int SharedBufferList::buffers() {
+    return (int)m_header->bufferCount;
+}
+
+/********************************************
+** Function: regionBytes()
+** Pre-conditions: None
+** Post-conditions: Returns the size of the region in bytes
+********************************************/
+size_t SharedBufferList::regionBytes() {
+    return m_size;
+}
+
+/********************************************
+** Function: segmentAt(uint64_t offset)
+** Pre-conditions: offset is the offset of a buffer in the region
+** Post-conditions: Returns the buffer at offset in this process's mapping
+********************************************/
+SharedBufferList::Segment* SharedBufferList::segmentAt(uint64_t offset) {
+    return (Segment*)(m_base + offset);
+}
+
+/********************************************
+** Function: itemsOf(Segment* segment)
+** Pre-conditions: segment is in the region
+** Post-conditions: Returns the first item slot of segment, right after its header
+********************************************/
+int* SharedBufferList::itemsOf(Segment* segment) {
+    return (int*)(segment + 1);
+}
+
+/********************************************
+** Function: takeFree()
+** Pre-conditions: Only the producer calls it
+** Post-conditions: Returns the offset of a buffer the consumer handed back and takes
+** it off the free ring, or 0 if the ring is empty
+********************************************/
+uint64_t SharedBufferList::takeFree() {
+    uint64_t written = m_header->freeWrite.load(std::memory_order_acquire);
+    if (m_header->freeRead == written) return 0;
+
+    uint64_t* ring = (uint64_t*)(m_base + m_header->ringOffset);
+    uint64_t offset = ring[m_header->freeRead % m_header->bufferCount];
+    m_header->freeRead++;
+    return offset;
+}
+
+/********************************************
+** Function: giveBack(uint64_t offset)
+** Pre-conditions: Only the consumer calls it, the buffer at offset is drained and the
+** producer has linked past it
+** Post-conditions: The buffer is reset and pushed on the free ring. The ring never
+** overflows: it has a slot per buffer and the head is never on it.
+********************************************/
+void SharedBufferList::giveBack(uint64_t offset) {
+    Segment* segment = segmentAt(offset);
+    segment->start = 0;
+    segment->end.store(0, std::memory_order_relaxed);
+    segment->next.store(0, std::memory_order_relaxed);
+
+    uint64_t* ring = (uint64_t*)(m_base + m_header->ringOffset);
+    uint64_t written = m_header->freeWrite.load(std::memory_order_relaxed);
+    ring[written % m_header->bufferCount] = offset;
+    m_header->freeWrite.store(written + 1, std::memory_order_release);
+}
+
+/********************************************
+** Function: advanceHead()
+** Pre-conditions: Only the consumer calls it, the head is drained
+** Post-conditions: If the producer has linked another buffer after the head, that one
+** becomes the head, the old head is handed back and true is returned, otherwise false
+********************************************/
+bool SharedBufferList::advanceHead() {
+    Segment* head = segmentAt(m_header->head);
+    uint64_t next = head->next.load(std::memory_order_acquire);
+    if (next == 0) return false;
+
+    uint64_t drained = m_header->head;
+    m_header->head = next;
+    giveBack(drained);
+    return true;
+}
+
+/********************************************
+** Function: map(int fd, size_t size)
+** Pre-conditions: fd is a shared memory object of at least size bytes
+** Post-conditions: size bytes are mapped shared into m_base and fd is closed. Throws
+** std::system_error if the mapping fails.
+********************************************/
+void SharedBufferList::map(int fd, size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    close(fd);
+    if (memory == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "mmap");
+    }
+    m_base = (char*)memory;
+    m_size = size;
+    m_reservedCount = 0;
+}
@@ -0,0 +1,102 @@
+/******************************************************************************************
+** File: sharedbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the SharedBufferList class.
+** This class is a single producer, single consumer list of int buffers that lives in a
+** POSIX shared memory region, so a producer process and a consumer process can hand
+** items over without a pipe. The producer writes straight into region memory through
+** reserve and commit, and the consumer reads it in place through peekBatch and consume.
+**
+** Nothing in the region is a pointer, since each process maps it at its own address:
+** buffers are linked by their offset from the start of the region. The region holds a
+** fixed number of buffers of one capacity. Drained buffers go back to the producer
+** through a ring of free offsets, so no lock is shared between the processes; a
+** producer that runs out of buffers is told so and can retry later.
+******************************************************************************************/
+
+
+
+#ifndef SHAREDBUFFERLIST_H
+#define SHAREDBUFFERLIST_H
+#include "buffer.h"
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const uint32_t SHARED_MAGIC = 0x42534831;   // "BSH1", marks an initialized region
+class SharedBufferList{
+    public:
+    friend class Grader;//Grader will have access to private members of SharedBufferList
+    friend class Tester;//Tester will have access to private members of SharedBufferList
+    SharedBufferList(const std::string & name, int bufferCapacity, int buffers); //creates the region name
+    SharedBufferList(const std::string & name);     //maps the existing region name
+    ~SharedBufferList();                            //unmaps the region, it stays until remove
+    SharedBufferList(const SharedBufferList & rhs) = delete;    //one mapping per object
+    SharedBufferList & operator=(const SharedBufferList & rhs) = delete;
+    static void remove(const std::string & name);   //deletes the region name once every process is done
+
+    // producer side
+    BufferReservation reserve(int n);   //writable region slots for up to n new items
+    void commit(int k);                 //publishes the first k reserved slots to the consumer
+    bool tryEnqueue(const int & data);  //adds data, false if every buffer is full
+    int enqueueBatch(const int * data, int n);  //adds up to n items, returns how many fit
+
+    // consumer side
+    BufferView peekBatch(int n);        //view of up to n oldest items in region memory, no copying
+    int consume(int k);                 //removes up to k oldest items, returns how many
+    bool tryDequeue(int & data);        //removes the oldest item into data, false if there is none
+    int dequeueBatch(int * out, int n); //moves up to n oldest items to out, returns how many
+
+    int count();                        //items published and not yet consumed, approximate while in use
+    bool empty();                       //returns true if nothing is published and not consumed
+    int bufferCapacity();               //items per buffer
+    int buffers();                      //buffers in the region
+    size_t regionBytes();               //size of the region
+
+
+    private:
+    // one buffer inside the region, its items follow the header
+    struct alignas(CACHE_LINE_SIZE) Segment{
+        std::atomic<uint64_t> next; // offset of the next buffer, 0 until the producer links one
+        std::atomic<uint32_t> end;  // items published, written by the producer
+        uint32_t start;             // items consumed, only used by the consumer
+    };
+    // the start of the region, each side's fields on their own cache lines
+    struct alignas(CACHE_LINE_SIZE) Header{
+        std::atomic<uint32_t> magic;    // SHARED_MAGIC once the creator has set up the region
+        uint32_t capacity;              // items per buffer
+        uint32_t bufferCount;           // buffers in the region
+        uint64_t segmentBytes;          // bytes per buffer, header and items
+        uint64_t regionBytes;           // size of the region
+        uint64_t ringOffset;            // offset of the free ring, bufferCount offsets
+        alignas(CACHE_LINE_SIZE) uint64_t tail;     // producer: offset of the buffer written into
+        uint64_t spare;                             // producer: a free buffer taken by reserve, 0 if none
+        std::atomic<uint64_t> produced;             // producer: items published so far
+        uint64_t freeRead;                          // producer: free ring entries taken so far
+        alignas(CACHE_LINE_SIZE) uint64_t head;     // consumer: offset of the buffer read from
+        std::atomic<uint64_t> consumed;             // consumer: items consumed so far
+        std::atomic<uint64_t> freeWrite;            // consumer: free ring entries handed back so far
+    };
+    char *m_base;           //where the region is mapped in this process
+    Header *m_header;       //the region's header, at m_base
+    size_t m_size;          //bytes mapped
+    int m_reservedCount;    //slots handed out by the last reserve, producer only
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    Segment* segmentAt(uint64_t offset);    //the buffer at offset
+    int* itemsOf(Segment* segment);         //first item slot of segment
+    uint64_t takeFree();                    //producer: pops a free buffer's offset, 0 if none
+    void giveBack(uint64_t offset);         //consumer: resets a drained buffer and pushes it on the free ring
+    bool advanceHead();                     //consumer: moves past a drained head if another buffer follows
+    void map(int fd, size_t size);          //maps size bytes of fd into m_base
+};
+#endif
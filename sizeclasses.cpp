@@ -0,0 +1,112 @@
+/******************************************************************************************
+** File: sizeclasses.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the SizeClassTable class.
+** Classes are a cache line times 2^k and times 3 * 2^k, which keeps the steps at most
+** 1.5x apart. Candidates of a page or more that are not whole pages are skipped.
+******************************************************************************************/
+
+#include "sizeclasses.h"
+#include <climits>
+#include <unistd.h>
+
+const long long MAX_CLASS_BYTES = 1LL << 30;    // largest class, 1 GiB of items
+
+/********************************************
+** Function: instance()
+** Pre-conditions: None
+** Post-conditions: Returns the table built from sysconf on first use. Line or page
+** sizes the system does not report fall back to 64 and 4096 bytes.
+********************************************/
+SizeClassTable& SizeClassTable::instance() {
+    static SizeClassTable table([]() {
+        long line = -1;
+#ifdef _SC_LEVEL1_DCACHE_LINESIZE
+        line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+#endif
+        return (line > 0) ? (int)line : 64;
+    }(), []() {
+        long page = sysconf(_SC_PAGESIZE);
+        return (page > 0) ? (int)page : 4096;
+    }());
+    return table;
+}
+
+/********************************************
+** Function: SizeClassTable(int lineSize, int pageSize)
+** Pre-conditions: lineSize and pageSize are multiples of sizeof(int)
+** Post-conditions: The classes are a line times 2^k and 3 * 2^k up to MAX_CLASS_BYTES,
+** keeping only whole pages once a class reaches a page
+********************************************/
+SizeClassTable::SizeClassTable(int lineSize, int pageSize) {
+    m_lineSize = lineSize;
+    m_pageSize = pageSize;
+    m_classCount = 0;
+
+    for (long long bytes = lineSize; bytes <= MAX_CLASS_BYTES && m_classCount < MAX_SIZE_CLASSES; bytes *= 2) {
+        long long candidates[2] = {bytes, bytes * 3 / 2};
+        for (int i = 0; i < 2; i++) {
+            long long size = candidates[i];
+            bool wholeLines = size % lineSize == 0;
+            bool wholePages = size < pageSize || size % pageSize == 0;
+            bool ascending = m_classCount == 0 || size / (long long)sizeof(int) > m_classes[m_classCount - 1];
+            if (wholeLines && wholePages && ascending && size <= MAX_CLASS_BYTES && m_classCount < MAX_SIZE_CLASSES) {
+                m_classes[m_classCount++] = (int)(size / sizeof(int));
+            }
+        }
+    }
+}
+
+/********************************************
+** Function: roundUp(int capacity)
+** Pre-conditions: None
+** Post-conditions: Returns the smallest class of at least capacity items, or capacity
+** itself if it is larger than every class
+********************************************/
+int SizeClassTable::roundUp(int capacity) {
+    for (int i = 0; i < m_classCount; i++) {
+        if (m_classes[i] >= capacity) {
+            return m_classes[i];
+        }
+    }
+    return capacity;
+}
+
+/********************************************
+** Function: lineSize(), pageSize(), classCount(), classAt(int index)
+** Pre-conditions: index is between 0 and classCount() - 1
+** Post-conditions: Return the calibration and the classes
+********************************************/
+int SizeClassTable::lineSize() {
+    return m_lineSize;
+}
+
+int SizeClassTable::pageSize() {
+    return m_pageSize;
+}
+
+int SizeClassTable::classCount() {
+    return m_classCount;
+}
+
+int SizeClassTable::classAt(int index) {
+    return m_classes[index];
+}
+
+/********************************************
+** Function: dump()
+** Pre-conditions: None
+** Post-conditions: The calibration and every class are printed to the console
+********************************************/
+void SizeClassTable::dump() {
+    std::cout << "Line " << m_lineSize << " B, page " << m_pageSize << " B, classes: ";
+    for (int i = 0; i < m_classCount; i++) {
+        std::cout << m_classes[i] << " ";
+    }
+    std::cout << std::endl;
+}
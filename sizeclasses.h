@@ -0,0 +1,44 @@
+/******************************************************************************************
+** File: sizeclasses.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the SizeClassTable class.
+** This class holds the buffer capacities a BufferList may round to. Every class fills
+** whole cache lines, and every class of a page or more fills whole pages, so no
+** allocation ends in a partly used line or page. The table is built once, from the
+** cache line and page sizes the system reports.
+******************************************************************************************/
+
+
+
+#ifndef SIZECLASSES_H
+#define SIZECLASSES_H
+#include <iostream>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+const int MAX_SIZE_CLASSES = 64;
+class SizeClassTable{
+    public:
+    friend class Grader;//Grader will have access to private members of SizeClassTable
+    friend class Tester;//Tester will have access to private members of SizeClassTable
+    static SizeClassTable & instance();     //the table calibrated for this machine
+    SizeClassTable(int lineSize, int pageSize); //builds a table for the given line and page sizes
+    int roundUp(int capacity);  //smallest class holding at least capacity items
+    int lineSize();             //cache line size in bytes
+    int pageSize();             //page size in bytes
+    int classCount();           //number of classes
+    int classAt(int index);     //capacity of class index, in items
+    void dump();                //prints out the classes, for debugging purposes
+
+
+    private:
+    int m_lineSize;             // cache line size in bytes
+    int m_pageSize;             // page size in bytes
+    int m_classes[MAX_SIZE_CLASSES]; // capacities in items, ascending
+    int m_classCount;           // number of classes in use
+};
+#endif
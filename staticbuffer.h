@@ -0,0 +1,177 @@
+/******************************************************************************************
+** File: staticbuffer.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration and implementation for the StaticBuffer class template.
+** This class is a circular buffer like Buffer, but its capacity N is a template argument
+** and its items live inside the object, so it never allocates. When N is a power of two
+** the wrap around is a mask, otherwise it is a compare against a constant. Every
+** operation is constexpr, so a StaticBuffer can be filled and drained at compile time.
+******************************************************************************************/
+
+
+
+#ifndef STATICBUFFER_H
+#define STATICBUFFER_H
+#include <stdexcept>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+template <typename T, int N>
+class StaticBuffer{
+    static_assert(N > 0, "StaticBuffer needs a capacity of at least 1");
+    public:
+    friend class Grader;//Grader will have access to private members of StaticBuffer
+    friend class Tester;//Tester will have access to private members of StaticBuffer
+    constexpr StaticBuffer();           //constructor, the buffer is empty
+    constexpr void enqueue(const T & data); //inserts at the end
+    constexpr T dequeue();              //removes from start
+    constexpr const T & front() const;  //returns the oldest item without removing it
+    constexpr const T & back() const;   //returns the newest item without removing it
+    constexpr void clear();             //removes every item
+    constexpr bool empty() const;       //returns true if buffer holds no items
+    constexpr bool full() const;        //returns true if no space left in buffer
+    constexpr int count() const;        //returns number of items currently held in the buffer
+    static constexpr int capacity() { return N; }   //returns maximum number of items, known at compile time
+
+
+    private:
+    T m_buffer[N] = {};     // the items, stored inline
+    int m_count ;           // current number of items in the buffer
+    int m_start ;           // index of the first (oldest) item in the buffer
+    int m_end ;             // index one past the newest item in the buffer
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    static constexpr int advance(int index);    //index + 1, wrapped to the capacity
+};
+
+/********************************************
+** Function: StaticBuffer()
+** Pre-conditions: T is default constructible
+** Post-conditions: An empty buffer with N inline slots is created
+********************************************/
+template <typename T, int N>
+constexpr StaticBuffer<T, N>::StaticBuffer() : m_count(0), m_start(0), m_end(0) {
+}
+
+/********************************************
+** Function: enqueue(const T& data)
+** Pre-conditions: None
+** Post-conditions: data is added at the end, throws overflow_error if the buffer is full
+********************************************/
+template <typename T, int N>
+constexpr void StaticBuffer<T, N>::enqueue(const T & data) {
+    if (full()) {
+        throw std::overflow_error("No space for enqueue!");
+    }
+    m_buffer[m_end] = data;
+    m_end = advance(m_end);
+    m_count++;
+}
+
+/********************************************
+** Function: dequeue()
+** Pre-conditions: None
+** Post-conditions: The oldest item is removed and returned, throws underflow_error if
+** the buffer is empty
+********************************************/
+template <typename T, int N>
+constexpr T StaticBuffer<T, N>::dequeue() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+    T data = m_buffer[m_start];
+    m_start = advance(m_start);
+    m_count--;
+    return data;
+}
+
+/********************************************
+** Function: front()
+** Pre-conditions: None
+** Post-conditions: Returns the oldest item, throws underflow_error if the buffer is empty
+********************************************/
+template <typename T, int N>
+constexpr const T & StaticBuffer<T, N>::front() const {
+    if (empty()) {
+        throw std::underflow_error("Buffer is empty!");
+    }
+    return m_buffer[m_start];
+}
+
+/********************************************
+** Function: back()
+** Pre-conditions: None
+** Post-conditions: Returns the newest item, throws underflow_error if the buffer is empty
+********************************************/
+template <typename T, int N>
+constexpr const T & StaticBuffer<T, N>::back() const {
+    if (empty()) {
+        throw std::underflow_error("Buffer is empty!");
+    }
+    return m_buffer[(m_end == 0) ? N - 1 : m_end - 1];
+}
+
+/********************************************
+** Function: clear()
+** Pre-conditions: None
+** Post-conditions: The buffer is empty, there is no memory to release
+********************************************/
+template <typename T, int N>
+constexpr void StaticBuffer<T, N>::clear() {
+    m_count = 0;
+    m_start = 0;
+    m_end = 0;
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if the buffer holds no items
+********************************************/
+template <typename T, int N>
+constexpr bool StaticBuffer<T, N>::empty() const {
+    return m_count == 0;
+}
+
+/********************************************
+** Function: full()
+** Pre-conditions: None
+** Post-conditions: Returns true if no space is left
+********************************************/
+template <typename T, int N>
+constexpr bool StaticBuffer<T, N>::full() const {
+    return m_count == N;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items held
+********************************************/
+template <typename T, int N>
+constexpr int StaticBuffer<T, N>::count() const {
+    return m_count;
+}
+
+/********************************************
+** Function: advance(int index)
+** Pre-conditions: index is between 0 and N - 1
+** Post-conditions: Returns the slot after index. A power of two capacity wraps with a
+** mask, any other capacity with a compare, never with a division.
+********************************************/
+template <typename T, int N>
+constexpr int StaticBuffer<T, N>::advance(int index) {
+    if constexpr ((N & (N - 1)) == 0) {
+        return (index + 1) & (N - 1);
+    }
+    else {
+        return (index + 1 == N) ? 0 : index + 1;
+    }
+}
+#endif
@@ -0,0 +1,157 @@
+/******************************************************************************************
+** File: staticbufferlist.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration and implementation for the StaticBufferList class template.
+** This class is a circular list of SEGMENTS StaticBuffer<T, N> segments held inside the
+** object, linked by index instead of by pointer. Like BufferList it fills the cursor
+** segment and moves on to the next one, and it drains the front segment and moves
+** past it, but the segments are reused instead of allocated, so it never touches the
+** heap. It holds at most N * SEGMENTS items.
+******************************************************************************************/
+
+
+
+#ifndef STATICBUFFERLIST_H
+#define STATICBUFFERLIST_H
+#include "staticbuffer.h"
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+template <typename T, int N, int SEGMENTS>
+class StaticBufferList{
+    static_assert(SEGMENTS > 0, "StaticBufferList needs at least one segment");
+    public:
+    friend class Grader;//Grader will have access to private members of StaticBufferList
+    friend class Tester;//Tester will have access to private members of StaticBufferList
+    constexpr StaticBufferList();       //constructor, the list is empty
+    constexpr void enqueue(const T & data); //add data
+    constexpr T dequeue();              //remove data
+    constexpr const T & front() const;  //returns the oldest data without removing it
+    constexpr void clear();             //removes every item
+    constexpr bool empty() const;       //returns true if there is nothing to dequeue
+    constexpr int count() const;        //returns the number of items in the list
+    static constexpr int capacity() { return N * SEGMENTS; }   //most items the list can hold
+
+
+    private:
+    StaticBuffer<T, N> m_segments[SEGMENTS];    //the segments, used as a ring
+    int m_front;        //index of the segment holding the oldest items
+    int m_cursor;       //index of the segment new items go to
+    int m_used;         //number of segments from m_front to m_cursor
+    int m_count;        //number of items in the list
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    static constexpr int nextSegment(int index);    //index + 1, wrapped to SEGMENTS
+};
+
+/********************************************
+** Function: StaticBufferList()
+** Pre-conditions: T is default constructible
+** Post-conditions: An empty list is created, the first segment is the front and cursor
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr StaticBufferList<T, N, SEGMENTS>::StaticBufferList()
+    : m_segments(), m_front(0), m_cursor(0), m_used(1), m_count(0) {
+}
+
+/********************************************
+** Function: enqueue(const T& data)
+** Pre-conditions: None
+** Post-conditions: data is added to the cursor segment, moving on to the next segment
+** when the cursor is full. Throws overflow_error if every segment is in use and full.
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr void StaticBufferList<T, N, SEGMENTS>::enqueue(const T & data) {
+    if (m_segments[m_cursor].full()) {
+        if (m_used == SEGMENTS) {
+            throw std::overflow_error("No space for enqueue!");
+        }
+        m_cursor = nextSegment(m_cursor);
+        m_used++;
+    }
+    m_segments[m_cursor].enqueue(data);
+    m_count++;
+}
+
+/********************************************
+** Function: dequeue()
+** Pre-conditions: None
+** Post-conditions: The oldest data is removed and returned. A front segment that drains
+** is released for reuse unless it is the cursor. Throws underflow_error if empty.
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr T StaticBufferList<T, N, SEGMENTS>::dequeue() {
+    if (empty()) {
+        throw std::underflow_error("Nothing to dequeue!");
+    }
+    T data = m_segments[m_front].dequeue();
+    m_count--;
+    if (m_segments[m_front].empty() && m_front != m_cursor) {
+        m_front = nextSegment(m_front);
+        m_used--;
+    }
+    return data;
+}
+
+/********************************************
+** Function: front()
+** Pre-conditions: None
+** Post-conditions: Returns the oldest data, throws underflow_error if the list is empty
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr const T & StaticBufferList<T, N, SEGMENTS>::front() const {
+    return m_segments[m_front].front();
+}
+
+/********************************************
+** Function: clear()
+** Pre-conditions: None
+** Post-conditions: Every segment is emptied and the list starts over at the first one
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr void StaticBufferList<T, N, SEGMENTS>::clear() {
+    for (int i = 0; i < SEGMENTS; i++) {
+        m_segments[i].clear();
+    }
+    m_front = 0;
+    m_cursor = 0;
+    m_used = 1;
+    m_count = 0;
+}
+
+/********************************************
+** Function: empty()
+** Pre-conditions: None
+** Post-conditions: Returns true if there is nothing to dequeue
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr bool StaticBufferList<T, N, SEGMENTS>::empty() const {
+    return m_count == 0;
+}
+
+/********************************************
+** Function: count()
+** Pre-conditions: None
+** Post-conditions: Returns the number of items in the list
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr int StaticBufferList<T, N, SEGMENTS>::count() const {
+    return m_count;
+}
+
+/********************************************
+** Function: nextSegment(int index)
+** Pre-conditions: index is between 0 and SEGMENTS - 1
+** Post-conditions: Returns the segment after index in the ring
+********************************************/
+template <typename T, int N, int SEGMENTS>
+constexpr int StaticBufferList<T, N, SEGMENTS>::nextSegment(int index) {
+    return (index + 1 == SEGMENTS) ? 0 : index + 1;
+}
+#endif
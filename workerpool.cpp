@@ -0,0 +1,147 @@
+/******************************************************************************************
+** File: workerpool.cpp
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the implementation for the WorkerPool class.
+** Tasks are claimed with an atomic counter, so workers that finish early take more.
+** The first exception thrown by a task is rethrown to the caller of run.
+******************************************************************************************/
+
+#include "workerpool.h"
+
+/********************************************
+** Function: WorkerPool(int threads)
+** Pre-conditions: threads is 0 or larger
+** Post-conditions: threads - 1 helper threads are started and wait for work. With 0
+** the number of hardware threads is used.
+********************************************/
+WorkerPool::WorkerPool(int threads) {
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+    m_task = nullptr;
+    m_tasks = 0;
+    m_next = 0;
+    m_batch = 0;
+    m_busy = 0;
+    m_stop = false;
+    for (int i = 1; i < threads; i++) {
+        m_workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+/********************************************
+** Function: ~WorkerPool()
+** Pre-conditions: No batch is running
+** Post-conditions: Every helper thread is stopped and joined
+********************************************/
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread & worker : m_workers) {
+        worker.join();
+    }
+}
+
+/********************************************
+** Function: run(int tasks, const std::function<void(int)>& task)
+** Pre-conditions: Only one thread calls run at a time
+** Post-conditions: task was called once for every index in [0, tasks), spread over
+** the workers and the caller. Rethrows the first exception a task threw.
+********************************************/
+void WorkerPool::run(int tasks, const std::function<void(int)>& task) {
+    if (tasks <= 0) return;
+
+    if (m_workers.empty() || tasks == 1) {
+        for (int i = 0; i < tasks; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_tasks = tasks;
+        m_next = 0;
+        m_error = nullptr;
+        m_busy = (int)m_workers.size();
+        m_batch++;
+    }
+    m_wake.notify_all();
+
+    drainTasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+    if (m_error) {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/********************************************
+** Function: threads()
+** Pre-conditions: None
+** Post-conditions: Returns the helper threads plus the calling thread
+********************************************/
+int WorkerPool::threads() {
+    return (int)m_workers.size() + 1;
+}
+
+/********************************************
+** Function: workerLoop()
+** Pre-conditions: None
+** Post-conditions: Runs every batch it is woken for until the pool is destroyed
+********************************************/
+void WorkerPool::workerLoop() {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen] { return m_stop || m_batch != seen; });
+            if (m_stop) return;
+            seen = m_batch;
+        }
+
+        drainTasks();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+/********************************************
+** Function: drainTasks()
+** Pre-conditions: A batch is running
+** Post-conditions: Tasks are claimed and run until every index is taken. An exception
+** is recorded and the remaining tasks of the batch are skipped.
+********************************************/
+void WorkerPool::drainTasks() {
+    while (true) {
+        int index = m_next.fetch_add(1);
+        if (index >= m_tasks) return;
+        try {
+            (*m_task)(index);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+            m_next = m_tasks;
+        }
+    }
+}
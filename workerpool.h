@@ -0,0 +1,59 @@
+/******************************************************************************************
+** File: workerpool.h
+** Project: CSCE 221 Project 1, Fall 2024
+** Author: Daniel Wu
+** Date: 9/19/2024
+** Section: 597
+** E-mail: DanielWu1510@tamu.edu
+**
+** This file contains the declaration for the WorkerPool class.
+** This class keeps a fixed set of worker threads alive and runs batches of numbered
+** tasks on them. The calling thread works on the batch too and returns once every
+** task has finished. BufferList uses it to process its buffers in parallel.
+******************************************************************************************/
+
+
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <vector>
+class Grader;//this class is for grading purposes, no need to do anything
+class Tester;
+class WorkerPool{
+    public:
+    friend class Grader;//Grader will have access to private members of WorkerPool
+    friend class Tester;//Tester will have access to private members of WorkerPool
+    WorkerPool(int threads = 0);    //constructor, 0 means one thread per hardware thread
+    ~WorkerPool();                  //destructor, joins the workers
+    WorkerPool(const WorkerPool & rhs) = delete;            //a pool owns its threads
+    WorkerPool & operator=(const WorkerPool & rhs) = delete;
+    void run(int tasks, const std::function<void(int)> & task); //runs task(0) .. task(tasks-1), waits for all
+    int threads();          //number of threads working on a batch, the caller included
+
+
+    private:
+    std::vector<std::thread> m_workers;     // helper threads, the caller is the last worker
+    std::mutex m_mutex;                     // guards the batch fields below
+    std::condition_variable m_wake;         // signals a new batch or shutdown
+    std::condition_variable m_done;         // signals that the workers left the batch
+    const std::function<void(int)> * m_task;// task of the current batch
+    int m_tasks;                            // number of tasks in the current batch
+    std::atomic<int> m_next;                // next task index to claim
+    unsigned long m_batch;                  // incremented for every batch
+    int m_busy;                             // workers still inside the current batch
+    bool m_stop;                            // set by the destructor
+    std::exception_ptr m_error;             // first exception thrown by a task
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+    void workerLoop();      //body of every helper thread
+    void drainTasks();      //claims and runs tasks until none are left
+};
+#endif